@@ -17,6 +17,38 @@
 #include <limits>
 #include <cstdlib>
 #include <ctime>
+#include <algorithm>
+#include <functional>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <mutex>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <cstdio>
+#include <iterator>
+#include <new>
+
+#include <cerrno>
+#include <cstring>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/epoll.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+
+#if defined (__GNUC__) && (defined (__x86_64__) || defined (__i386__))
+	#define NUMBERCRUSH_X86
+	#include <immintrin.h>
+#endif
 
 using namespace std;
 
@@ -31,9 +63,80 @@ namespace nsNumberCrush
 	typedef vector <string>				CVString; /*!<   \brief a type representing a matrix of string */
 	typedef vector <unsigned>			CVUInt;/*!<   \brief a type representing a vector of unsigned */
 	typedef vector <char>				CVLine;/*!<   \brief a type representing a row of the matrix */
-	typedef vector <CVLine>				CMat;/*!<  \brief a type representing the matrix  */
 	typedef pair <unsigned, unsigned>	CPosition;/*!<   \brief a type representing a position in the matrix  */
 	typedef vector <CPosition>			CVPair;/*!< \brief a type representing a matrix of position  */
+	typedef vector <unsigned long long>	CMask;/*!< \brief a type representing a bitmask with one bit per cell of the matrix */
+
+	/** \struct CRun
+	 *
+	 * \brief a maximal sequence of identical numbers found in the matrix
+	 *
+	 */
+	struct CRun
+	{
+		CPosition	Start;	/*!< \brief position of the first cell (top or left) of the sequence */
+		char		Axis;	/*!< \brief KAxisRow or KAxisColumn */
+		unsigned	Length;	/*!< \brief how many consecutive numbers the sequence holds */
+	};
+	typedef vector <CRun>				CVRun;/*!< \brief a type representing a list of sequences */
+	/** \struct CDirtyRegion
+	 *
+	 * \brief the cells changed since the last search of sequences, as an interval of rows in each column
+	 *
+	 */
+	struct CDirtyRegion
+	{
+		CVUInt	VColumns;	/*!< \brief the dirty columns, each one listed once */
+		CVUInt	VTop;		/*!< \brief first dirty row of each column, 0 when the column is clean */
+		CVUInt	VBottom;	/*!< \brief last dirty row of each column */
+	};
+	/** \struct CMove
+	 *
+	 * \brief a move of the player : a position and a direction
+	 *
+	 */
+	struct CMove
+	{
+		CPosition	Pos;		/*!< \brief position of the moved number */
+		char		Direction;	/*!< \brief 'Z', 'S', 'Q' or 'D' */
+	};
+	typedef vector <CMove>				CVMove;/*!< \brief a type representing a list of moves */
+	/** \struct CCellChange
+	 *
+	 * \brief the value a cell held before being changed
+	 *
+	 */
+	struct CCellChange
+	{
+		unsigned	Offset;	/*!< \brief index of the cell in the buffer of the matrix */
+		char		Value;	/*!< \brief its previous value */
+	};
+	typedef vector <CCellChange>		CVCellChange;/*!< \brief a type representing a list of cell changes */
+	/** \struct CView
+	 *
+	 * \brief the part of the matrix shown on screen
+	 *
+	 */
+	struct CView
+	{
+		unsigned	Top;		/*!< \brief first row shown */
+		unsigned	Left;		/*!< \brief first column shown */
+		unsigned	NbRows;		/*!< \brief how many rows are shown */
+		unsigned	NbColumns;	/*!< \brief how many columns are shown */
+	};
+	/** \struct CConfigKey
+	 *
+	 * \brief a setting of the config file : its label, default value and range
+	 *
+	 */
+	struct CConfigKey
+	{
+		const char*			Label;		/*!< \brief name of the setting in the config file */
+		unsigned long long	Default;	/*!< \brief value when the file does not give a valid one */
+		unsigned long long	Min;		/*!< \brief smallest valid value */
+		unsigned long long	Max;		/*!< \brief greatest valid value */
+	};
+	typedef unsigned (*CEqual3Kernel) (const char*, const char*, const char*);/*!< \brief a type representing a comparison kernel of KLanes cells */
 
 	//Colors
 	
@@ -45,18 +148,901 @@ namespace nsNumberCrush
 	const string KBlue	 = "34";/*!< \brief a type to set a string in blue */
 	const string KMagenta = "35";/*!< \brief a type to set a string in magenta */
 	const string KCyan   =  "36";/*!< \brief a type to set a string in cyan */
+	const string KCandyColors [] = { KRed, KGreen, KYellow, KBlue, KMagenta, KCyan };/*!< \brief the color of each number, from '1' */
+	const unsigned KNbCandyColors = sizeof (KCandyColors) / sizeof (KCandyColors [0]);/*!< \brief number of colors of the numbers */
 
 	//Files Name
 	const string KConfigFileName 	=	("config.cfg");/*!< \brief a type to name the config file */
+	const string KReplayDirName		=	("replays");/*!<  \brief a type to name the directory of the replays */
+	const string KReplayExtension	=	(".ncr");/*!<  \brief extension of a replay file */
+	const string KReplayMagic		=	("NCR2");/*!<  \brief first bytes of a replay file */
+	const string KReplayMagicV1		=	("NCR1");/*!<  \brief first bytes of a replay file written before the special cells, played without them */
+	const unsigned KMaxBoardSize	= 10000;/*!<  \brief rows or columns of the largest matrix */
+	const CConfigKey KConfigKeys [] =
+	{
+		{ "MatrixWidth",	10,	5,	KMaxBoardSize },
+		{ "MatrixHeigth",	10,	5,	KMaxBoardSize },
+		{ "NbCandies",		5,	3,	7 },
+		{ "NbMaxTimes",		20,	1,	1000 },
+		{ "Seed",			0,	0,	numeric_limits <unsigned long long>::max () },
+		{ "NbThreads",		0,	0,	256 },
+		{ "AnimationFps",	0,	0,	120 },
+		{ "BitBoard",		1,	0,	1 },
+		{ "Specials",		1,	0,	1 },
+		{ "SaveScores",		1,	0,	1 }
+	};/*!< \brief the settings of the config file ; a Seed of 0 is taken from the clock, NbThreads of 0 is one per core, AnimationFps of 0 is no animation, BitBoard of 1 plays with a CBitBoard when the matrix fits, Specials of 1 makes special cells from the sequences of 4, 5 and in L or T, SaveScores of 1 records the score of every game played, the simulations being recorded only with "--save-scores 1" */
+	const unsigned KNbConfigKeys	= sizeof (KConfigKeys) / sizeof (KConfigKeys [0]);/*!< \brief number of settings of the config file */
 	const string KHeaderFileName	=	("header.txt");/*!<   \brief  a type to name the header file */
 	const string KMenuFileName		=	("menu.txt");/*!<  \brief a type to name the menu file */
 	const string KRulesFileName		=	("rules.txt");/*!<  \brief  a type to name the rules file */
 	const string KHelpFileName		=	("instructions.txt");/*!<  \brief  a type to name the help file */
 	const string KCreditsFileName	=	("credit.txt");/*!<  \brief  a type to name the credit file */
+	const string KShuffledStatus	=	("Plus aucun coup possible : la grille a ete melangee");/*!<  \brief status shown after a dead matrix was shuffled */
+	const string KNoStatus			=	("");/*!<  \brief empty status line */
 	
 
     const unsigned KSquareValue = 10; /*!<  \brief a type representing the score of a cell */
 	const char KImpossible		= '0';/*!<  \brief a type representing an empty cell */
+	const char KAxisRow			= 'R';/*!<  \brief axis of a sequence found in a row */
+	const char KAxisColumn		= 'C';/*!<  \brief axis of a sequence found in a column */
+	const char KColorBits		= 0x0F;/*!<  \brief bits of a cell giving its number, the others giving its kind, @see CellKind */
+	const unsigned KSpecialRow		= 1;/*!<  \brief kind of a special cell clearing its row, made by a sequence of 4 in column */
+	const unsigned KSpecialColumn	= 2;/*!<  \brief kind of a special cell clearing its column, made by a sequence of 4 in row */
+	const unsigned KSpecialBomb		= 3;/*!<  \brief kind of a special cell clearing the 3x3 square around it, made by two crossing sequences */
+	const unsigned KSpecialColor	= 4;/*!<  \brief kind of a special cell clearing every cell of its number, made by a sequence of 5 */
+	const char KSpecialMarks []	= { ' ', '-', '|', '*', '@' };/*!<  \brief mark shown after the number of a cell, for each kind */
+	const unsigned KMaskBits	= 64;/*!<  \brief number of cells stored in one word of a CMask */
+	const char KDirections []	= { 'Z', 'S', 'Q', 'D' };/*!<  \brief the directions of a move */
+	const char KHintCommand		= 'H';/*!<  \brief command asking for a hint */
+	const unsigned KUndoLogCapacity	= 4096;/*!<  \brief how many cell changes a CUndoLog holds before growing */
+	const unsigned KMaxShuffles	= 100;/*!<  \brief how many times a dead matrix is shuffled before being refilled */
+	const unsigned KMaxSpecialSteps	= 20;/*!<  \brief steps of a cascade making and firing special cells : with 3 numbers, the cells they clear are refilled with sequences for ever */
+	const unsigned KExpectimaxDepth		= 2;/*!<  \brief deepest search of CExpectimaxPolicy, in moves */
+	const unsigned KExpectimaxSamples	= 3;/*!<  \brief how many refills CExpectimaxPolicy draws after each move */
+	const unsigned KRolloutHorizon		= 5;/*!<  \brief how many moves a rollout of CMonteCarloPolicy plays */
+	const unsigned KNbRollouts			= 8;/*!<  \brief how many rollouts per move CMonteCarloPolicy plays without time budget */
+	const unsigned KSolverTableMb		= 64;/*!<  \brief default size of the transposition table of CSolver, in MB */
+	const unsigned short KNoMove		= 0xFFFF;/*!<  \brief index of no move in a list of moves */
+	const unsigned KGridTop		= 5;/*!<  \brief row of the screen where CRenderer draws the matrix */
+	const unsigned KViewTop		= 4;/*!<  \brief row of the screen where CRenderer writes the coordinates of the view */
+	const unsigned KViewRows	= 20;/*!<  \brief rows of the matrix shown at once ; a matrix with more rows or columns is a large board */
+	const unsigned KViewColumns	= 15;/*!<  \brief columns of the matrix shown at once */
+	const char KViewCommand		= 'V';/*!<  \brief command moving the view of a large board */
+	const unsigned KTileRows	= 64;/*!<  \brief rows of a tile of a large board, @see StabilizeTiles */
+	const unsigned KTileColumns	= 256;/*!<  \brief columns of a tile of a large board : 16 KB of cells */
+	const unsigned KScratchCells	= 4096;/*!<  \brief cells reserved in the buffers of CTurnScratch, which grow beyond on a large board */
+	const unsigned KCellHeigth	= 3;/*!<  \brief lines of the screen taken by a row of the matrix */
+	const unsigned KCellWidth	= 4;/*!<  \brief columns of the screen taken by a column of the matrix */
+	const unsigned KFrameCapacity	= 65536;/*!<  \brief bytes reserved for a frame of CRenderer */
+	const unsigned KReplayPosBits	= 14;/*!<  \brief bits of the row and of the column of a move in a replay file */
+	const unsigned KLanes		= 32;/*!<  \brief number of cells compared at once by a CEqual3Kernel */
+	const unsigned KBitWords	= 8;/*!<  \brief words of a plane of CBitBoard : 512 cells */
+	const unsigned KBitCandies	= 9;/*!<  \brief numbers a CBitBoard holds, '1' to '9' */
+	const unsigned KMaxBitColumns	= 64;/*!<  \brief columns of a CBitBoard at most */
+	const unsigned KBenchSizes []	= { 5, 10, 20, 50, 100, 200, 500, 1000 };/*!<  \brief sizes of the square matrices measured by Bench */
+	const unsigned KNbBenchSizes	= sizeof (KBenchSizes) / sizeof (KBenchSizes [0]);/*!<  \brief number of sizes measured by Bench */
+	const unsigned KBenchSamples	= 5;/*!<  \brief how many times Bench measures a kernel */
+	const double KBenchSampleNs		= 2e6;/*!<  \brief duration of a sample of Bench, in ns */
+	const unsigned KPhaseParse		= 0;/*!<  \brief phase of the instrumentation : CutInputStr */
+	const unsigned KPhaseSwap		= 1;/*!<  \brief phase of the instrumentation : MakeAMove */
+	const unsigned KPhaseDetection	= 2;/*!<  \brief phase of the instrumentation : search of the sequences */
+	const unsigned KPhaseRemoval	= 3;/*!<  \brief phase of the instrumentation : removal of the sequences */
+	const unsigned KPhaseFall		= 4;/*!<  \brief phase of the instrumentation : MoveNumbersDown */
+	const unsigned KPhaseFill		= 5;/*!<  \brief phase of the instrumentation : FillGrid */
+	const unsigned KPhaseRender		= 6;/*!<  \brief phase of the instrumentation : CRenderer::Draw */
+	const unsigned KNbPhases		= 7;/*!<  \brief number of phases, also meaning no phase */
+	const char* const KPhaseNames [KNbPhases] = { "ParseInput", "MakeAMove", "Detection", "Removal",
+												  "MoveNumbersDown", "FillGrid", "Render" };/*!<  \brief names of the phases */
+	const unsigned KMaxSessions		= 10000;/*!<  \brief games a server holds at once, @see Serve */
+	const unsigned KMaxLineSize		= 256;/*!<  \brief longest line a client of the server may send without ending it */
+	const unsigned KServerEvents	= 256;/*!<  \brief events read by one call to epoll_wait */
+	const unsigned KSocketBufferSize	= 4096;/*!<  \brief bytes read by one call to recv */
+	const unsigned KMaxPort			= 65535;/*!<  \brief greatest TCP port */
+	const unsigned KLoadClients		= 1000;/*!<  \brief clients of LoadTest when --clients is not given */
+	const string KServerGreeting	= ("NUMBERCRUSH");/*!<  \brief first word sent by the server to a new client */
+	const string KScoreLogName		= ("scores.log");/*!<  \brief the log of the scores, @see CScoreStore */
+	const string KScoreIndexName	= ("scores.idx");/*!<  \brief the index of the log of the scores, @see CScoreStore */
+	const string KScoreMagic		= ("NCS1");/*!<  \brief first bytes of the log of the scores */
+	const unsigned long long KScoreIndexMagic	= 0x3149434EULL;/*!<  \brief first bytes of the index of the scores, "NCI1" */
+	const unsigned KScoreNameSize	= 16;/*!<  \brief bytes of the name of a player in the log of the scores */
+	const unsigned KScoreRecordSize	= 48;/*!<  \brief bytes of a record of the log of the scores, @see AppendScoreRecord */
+	const unsigned KScoreTailSize	= 65536;/*!<  \brief records appended after the index before CScoreStore::Append merges them in it */
+	const unsigned KShownScores		= 10;/*!<  \brief lines of the leaderboards of the menu and of the end of a game */
+
+	/**
+	* \fn unsigned long long& : AllocationCount ()
+	* \brief function to get the number of heap allocations made by the current thread.
+	*/
+	inline unsigned long long& AllocationCount ()
+	{
+		static thread_local unsigned long long NbAllocations (0);
+		return NbAllocations;
+
+	}// AllocationCount ()
+
+	/** \struct CStats
+	 *
+	 * \brief the counters of the instrumentation, one per thread, @see Stats
+	 *
+	 * They are only updated when the program is compiled with NUMBERCRUSH_STATS :
+	 * otherwise CPhaseClock and the Count functions are empty and cost nothing.
+	 *
+	 */
+	struct CStats
+	{
+		unsigned long long	VNbCalls [KNbPhases];	/*!< \brief how many times each phase ran */
+		unsigned long long	VNs [KNbPhases];		/*!< \brief time spent in each phase, in ns */
+		unsigned long long	NbTurns;		/*!< \brief moves played by PlayMove */
+		unsigned long long	SumDepth;		/*!< \brief steps of cascade of these moves */
+		unsigned			MaxDepth;		/*!< \brief most steps of cascade of a move */
+		unsigned long long	SumMatches;		/*!< \brief sequences removed by these moves */
+		unsigned			MaxMatches;		/*!< \brief most sequences removed by a move */
+		unsigned long long	NbRandomDraws;	/*!< \brief numbers drawn by every CRandom */
+		unsigned			Depth;			/*!< \brief steps of cascade of the current move, moves of the searches included */
+	};
+
+	/**
+	* \fn CStats& : Stats ()
+	* \brief function to get the counters of the instrumentation of the current thread.
+	*/
+	inline CStats& Stats ()
+	{
+		static thread_local CStats ThreadStats = CStats ();
+		return ThreadStats;
+
+	}// Stats ()
+
+#ifdef NUMBERCRUSH_STATS
+	/** \class CPhaseClock
+	 *
+	 * \brief the time spent in the phases of a function, added to Stats when the phase changes and on destruction
+	 *
+	 */
+	class CPhaseClock
+	{
+		unsigned							m_Phase;	/*!< \brief the current phase, KNbPhases for none */
+		chrono::steady_clock::time_point	m_Begin;	/*!< \brief start of the current phase */
+
+	  public:
+		explicit CPhaseClock (const unsigned& Phase = KNbPhases) : m_Phase (Phase), m_Begin (chrono::steady_clock::now ()) {}
+		~CPhaseClock () { Switch (KNbPhases); }
+
+		/**
+		* \fn Switch (const unsigned& Phase)
+		* \brief function to end the current phase and start another one, KNbPhases for none.
+		*/
+		void Switch (const unsigned& Phase)
+		{
+			const chrono::steady_clock::time_point Now = chrono::steady_clock::now ();
+			if (m_Phase < KNbPhases)
+			{
+				CStats& ThreadStats = Stats ();
+				++ThreadStats.VNbCalls [m_Phase];
+				ThreadStats.VNs [m_Phase] += chrono::duration_cast <chrono::nanoseconds> (Now - m_Begin).count ();
+			}
+			m_Phase = Phase;
+			m_Begin = Now;
+		}
+
+	};// CPhaseClock
+
+	inline void CountRandomDraw ()	{ ++Stats ().NbRandomDraws; }
+	inline void CountCascadeStep ()	{ ++Stats ().Depth; }
+	inline void BeginMoveStats ()	{ Stats ().Depth = 0; }
+
+	/**
+	* \fn CountTurn (const unsigned& Matches)
+	* \brief function to count a move played, its cascade depth being the steps counted since BeginMoveStats.
+	*/
+	inline void CountTurn (const unsigned& Matches)
+	{
+		CStats& ThreadStats = Stats ();
+		++ThreadStats.NbTurns;
+		ThreadStats.SumDepth	+= ThreadStats.Depth;
+		ThreadStats.MaxDepth	 = max (ThreadStats.MaxDepth, ThreadStats.Depth);
+		ThreadStats.SumMatches	+= Matches;
+		ThreadStats.MaxMatches	 = max (ThreadStats.MaxMatches, Matches);
+
+	}// CountTurn ()
+#else
+	class CPhaseClock
+	{
+	  public:
+		explicit CPhaseClock (const unsigned& = KNbPhases) {}
+		void Switch (const unsigned&) {}
+
+	};// CPhaseClock
+
+	inline void CountRandomDraw ()	{}
+	inline void CountCascadeStep ()	{}
+	inline void BeginMoveStats ()	{}
+	inline void CountTurn (const unsigned&) {}
+#endif
+
+	/**
+	* \fn unsigned long long : SplitMix64 (unsigned long long& State)
+	* \brief function to get the next value of a SplitMix64 sequence, used to spread a seed.
+	*/
+	inline unsigned long long SplitMix64 (unsigned long long& State)
+	{
+		unsigned long long Z = (State += 0x9E3779B97F4A7C15ULL);
+		Z = (Z ^ (Z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		Z = (Z ^ (Z >> 27)) * 0x94D049BB133111EBULL;
+		return Z ^ (Z >> 31);
+
+	}// SplitMix64 ()
+
+	/**
+	* \fn unsigned long long : DeriveSeed (const unsigned long long& Master, const unsigned long long& Index)
+	* \brief function to get the seed of the game number Index from a master seed.
+	*/
+	inline unsigned long long DeriveSeed (const unsigned long long& Master, const unsigned long long& Index)
+	{
+		unsigned long long State = Master ^ (Index * 0xD1B54A32D192ED03ULL);
+		return SplitMix64 (State);
+
+	}// DeriveSeed ()
+
+	/** \class CRandom
+	 *
+	 * \brief a xoshiro256** random generator : each game owns one, so games are reproducible and independent
+	 *
+	 */
+	class CRandom
+	{
+		unsigned long long m_State [4];	/*!< \brief state of the generator */
+
+		static unsigned long long Rotl (const unsigned long long& X, const int& K) { return (X << K) | (X >> (64 - K)); }
+
+	  public:
+		explicit CRandom (const unsigned long long& Seed = 0) { SetSeed (Seed); }
+
+		/**
+		* \fn SetSeed (const unsigned long long& Seed)
+		* \brief function to restart the generator from a seed.
+		*/
+		void SetSeed (unsigned long long Seed)
+		{
+			for (unsigned k (0); k < 4; ++k)
+				m_State [k] = SplitMix64 (Seed);
+		}
+
+		/**
+		* \fn unsigned long long : Next ()
+		* \brief function to draw 64 random bits.
+		*/
+		unsigned long long Next ()
+		{
+			CountRandomDraw ();
+			const unsigned long long Result = Rotl (m_State [1] * 5, 7) * 9;
+			const unsigned long long T = m_State [1] << 17;
+
+			m_State [2] ^= m_State [0];
+			m_State [3] ^= m_State [1];
+			m_State [1] ^= m_State [2];
+			m_State [0] ^= m_State [3];
+			m_State [2] ^= T;
+			m_State [3] = Rotl (m_State [3], 45);
+
+			return Result;
+		}
+
+		/**
+		* \fn unsigned : Next (const unsigned& Bound)
+		* \brief function to draw a number between 0 and Bound - 1, without division.
+		*/
+		unsigned Next (const unsigned& Bound)
+		{
+			return unsigned (((Next () >> 32) * Bound) >> 32);
+		}
+
+	};// CRandom
+
+	/** \class CBoard
+	 *
+	 * \brief a type representing the matrix, stored row after row in one contiguous buffer
+	 *
+	 * The first and last rows and columns are the sentinel border built by InitGrid :
+	 * they always hold KImpossible, so the algorithms never test the bounds.
+	 * Grid [i][j] is the cell of the row i and the column j.
+	 *
+	 */
+	class CBoard
+	{
+		unsigned	m_Heigth;	/*!< \brief number of rows, border included */
+		unsigned	m_Width;	/*!< \brief number of columns, border included */
+		CVLine		m_Cells;	/*!< \brief all the cells, m_Width cells per row */
+
+	  public:
+		/** \class CColumn
+		 *
+		 * \brief a column-major view of one column of the matrix : Column [i] is the cell of the row i
+		 *
+		 */
+		class CColumn
+		{
+			char*		m_First;	/*!< \brief cell of the row 0 */
+			unsigned	m_Stride;	/*!< \brief distance between two rows */
+
+		  public:
+			CColumn (char* First, const unsigned& Stride) : m_First (First), m_Stride (Stride) {}
+
+			char& operator [] (const unsigned& Row) const { return m_First [Row * m_Stride]; }
+
+		};// CColumn
+
+		CBoard () : m_Heigth (0), m_Width (0) {}
+
+		/**
+		* \fn Resize (const unsigned& Heigth, const unsigned& Width)
+		* \brief function to give the matrix its size, every cell being set to KImpossible.
+		*/
+		void Resize (const unsigned& Heigth, const unsigned& Width)
+		{
+			m_Heigth = Heigth;
+			m_Width  = Width;
+			m_Cells.assign (Heigth * Width, KImpossible);
+		}
+
+		unsigned GetHeigth () const { return m_Heigth; }
+		unsigned GetWidth  () const { return m_Width;  }
+		unsigned GetStride () const { return m_Width;  }
+
+		char*		GetData ()			{ return m_Cells.data (); }
+		const char*	GetData () const	{ return m_Cells.data (); }
+
+		char*		operator [] (const unsigned& Row)		{ return &m_Cells [Row * m_Width]; }
+		const char*	operator [] (const unsigned& Row) const	{ return &m_Cells [Row * m_Width]; }
+
+		CColumn Column (const unsigned& Col) { return CColumn (&m_Cells [Col], m_Width); }
+
+		bool operator == (const CBoard& Board) const { return m_Width == Board.m_Width && m_Cells == Board.m_Cells; }
+		bool operator != (const CBoard& Board) const { return !(*this == Board); }
+
+	};// CBoard
+
+	/**
+	* \fn char : CellColor (const char& Cell)
+	* \brief function to get the number of a cell, from 1, 0 for KImpossible.
+	*/
+	inline char CellColor (const char& Cell) { return char (Cell & KColorBits); }
+
+	/**
+	* \fn unsigned : CellKind (const char& Cell)
+	* \brief function to get the kind of a cell : 0 for a plain number, KSpecialRow to KSpecialColor for a special cell.
+	*
+	* A cell is KImpossible + its number + 16 * its kind : '1' is a plain 1, 'Q' a 1 clearing its column.
+	*/
+	inline unsigned CellKind (const char& Cell) { return unsigned (Cell - KImpossible) >> 4; }
+
+	/**
+	* \fn char : MakeSpecial (const char& Cell, const unsigned& Kind)
+	* \brief function to get the special cell of a kind holding the number of Cell.
+	*/
+	inline char MakeSpecial (const char& Cell, const unsigned& Kind) { return char (KImpossible + CellColor (Cell) + 16 * Kind); }
+
+	/**
+	* \fn bool : IsSameColor (const char& A, const char& B)
+	* \brief function to test if two cells hold the same number, whatever their kind : they can make a sequence.
+	*/
+	inline bool IsSameColor (const char& A, const char& B) { return 0 == ((A ^ B) & KColorBits); }
+
+	/**
+	* \fn bool : IsLargeBoard (const CBoard& Grid)
+	* \brief function to test if a matrix does not fit on screen : it is shown through a view and filled tile by tile.
+	*/
+	inline bool IsLargeBoard (const CBoard& Grid)
+	{
+		return Grid.GetHeigth () - 2 > KViewRows || Grid.GetWidth () - 2 > KViewColumns;
+
+	}// IsLargeBoard ()
+
+	/** \struct CShape
+	 *
+	 * \brief the size of a matrix and its number of numbers known at compile time, border excluded
+	 *
+	 * The core rules are templates on a CShape : instantiated with constants, their loop
+	 * bounds and strides are constants too. A size of 0 is read at run time from the
+	 * matrix : CAnyShape is the generic version, used for any other matrix.
+	 *
+	 */
+	template <unsigned NbRows, unsigned NbCols, unsigned NbNumbers>
+	struct CShape
+	{
+		static unsigned GetHeigth (const CBoard& Grid) { return NbRows ? NbRows + 2 : Grid.GetHeigth (); }
+		static unsigned GetWidth  (const CBoard& Grid) { return NbCols ? NbCols + 2 : Grid.GetWidth ();  }
+		static unsigned GetNbCandies (const CVLine& Vect) { return NbNumbers ? NbNumbers : unsigned (Vect.size ()); }
+
+		static char Get (const CBoard& Grid, const unsigned& Row, const unsigned& Col)
+		{
+			return Grid.GetData () [Row * GetWidth (Grid) + Col];
+		}
+	};
+	typedef CShape <0, 0, 0> CAnyShape;/*!< \brief a type representing a matrix of any size */
+
+	/** \class CUndoLog
+	 *
+	 * \brief the changes of the cells of a matrix, to undo them back to any checkpoint
+	 *
+	 * The changes are written in an arena allocated once : recording a change
+	 * and rolling back do not allocate, unless the arena is full and doubles.
+	 *
+	 */
+	class CUndoLog
+	{
+		CVCellChange	m_Arena;	/*!< \brief the changes, the last one at m_Size - 1 */
+		unsigned		m_Size;		/*!< \brief how many changes are recorded */
+
+	  public:
+		explicit CUndoLog (const unsigned& Capacity = KUndoLogCapacity) : m_Arena (Capacity), m_Size (0) {}
+
+		/**
+		* \fn unsigned : GetCheckpoint () const
+		* \brief function to get a checkpoint : the matrix as it is now.
+		*/
+		unsigned GetCheckpoint () const { return m_Size; }
+
+		/**
+		* \fn Record (const CBoard& Grid, const char& Cell)
+		* \brief function to record the value of a cell of Grid before it is changed.
+		*/
+		void Record (const CBoard& Grid, const char& Cell)
+		{
+			if (m_Size == m_Arena.size ())
+				m_Arena.resize (2 * m_Arena.size () + 1);
+
+			m_Arena [m_Size].Offset = &Cell - Grid.GetData ();
+			m_Arena [m_Size].Value  = Cell;
+			++m_Size;
+		}
+
+		/**
+		* \fn Rollback (CBoard& Grid, const unsigned& Checkpoint)
+		* \brief function to undo the changes recorded since a checkpoint, the last first, in O(changed cells).
+		*/
+		void Rollback (CBoard& Grid, const unsigned& Checkpoint)
+		{
+			char* Cells = Grid.GetData ();
+			for ( ; m_Size > Checkpoint; )
+			{
+				--m_Size;
+				Cells [m_Arena [m_Size].Offset] = m_Arena [m_Size].Value;
+			}
+		}
+
+		/**
+		* \fn const CCellChange& : operator [] (const unsigned& i) const
+		* \brief function to get the change number i, the first recorded is 0.
+		*/
+		const CCellChange& operator [] (const unsigned& i) const { return m_Arena [i]; }
+
+		/**
+		* \fn Clear ()
+		* \brief function to forget every change, keeping the arena.
+		*/
+		void Clear () { m_Size = 0; }
+
+	};// CUndoLog
+
+	/**
+	* \fn LogCell (CUndoLog* Log, const CBoard& Grid, const char& Cell)
+	* \brief function to record the value of a cell before it is changed, when there is a log.
+	*/
+	inline void LogCell (CUndoLog* Log, const CBoard& Grid, const char& Cell)
+	{
+		if (Log) Log->Record (Grid, Cell);
+
+	}// LogCell ()
+
+	/**
+	* \fn MarkStep (const CUndoLog* Log, CVUInt* VSteps)
+	* \brief function to record the end of a step of a move, when there are a log and a list of steps.
+	*/
+	inline void MarkStep (const CUndoLog* Log, CVUInt* VSteps)
+	{
+		if (Log && VSteps) VSteps->push_back (Log->GetCheckpoint ());
+
+	}// MarkStep ()
+
+	/**
+	* \fn ShiftPlaneDown (const unsigned long long* Plane, const unsigned& Shift, const unsigned& NbWords, unsigned long long* Result)
+	* \brief function to shift a plane of a CBitBoard towards the bit 0 : bit k of Result is bit k + Shift of Plane.
+	*
+	*\param Shift : less than KMaskBits
+	*/
+	inline void ShiftPlaneDown (const unsigned long long* Plane, const unsigned& Shift, const unsigned& NbWords, unsigned long long* Result)
+	{
+		for (unsigned w (0); w < NbWords; ++w)
+			Result [w] = (Plane [w] >> Shift) | ((Shift && w + 1 < NbWords) ? Plane [w + 1] << (KMaskBits - Shift) : 0);
+
+	}// ShiftPlaneDown ()
+
+	/**
+	* \fn ShiftPlaneUp (const unsigned long long* Plane, const unsigned& Shift, const unsigned& NbWords, unsigned long long* Result)
+	* \brief function to shift a plane of a CBitBoard away from the bit 0 : bit k of Result is bit k - Shift of Plane.
+	*
+	*\param Shift : less than KMaskBits
+	*/
+	inline void ShiftPlaneUp (const unsigned long long* Plane, const unsigned& Shift, const unsigned& NbWords, unsigned long long* Result)
+	{
+		for (unsigned w = NbWords; w-- > 0; )
+			Result [w] = (Plane [w] << Shift) | ((Shift && w > 0) ? Plane [w - 1] >> (KMaskBits - Shift) : 0);
+
+	}// ShiftPlaneUp ()
+
+	/**
+	* \fn unsigned long long : GetPlaneBits (const unsigned long long* Plane, const unsigned& Offset, const unsigned& Count)
+	* \brief function to read Count bits of a plane from the bit Offset, Count being less than KMaskBits.
+	*/
+	inline unsigned long long GetPlaneBits (const unsigned long long* Plane, const unsigned& Offset, const unsigned& Count)
+	{
+		const unsigned Word  = Offset / KMaskBits;
+		const unsigned Shift = Offset % KMaskBits;
+
+		unsigned long long Bits = Plane [Word] >> Shift;
+		if (Shift + Count > KMaskBits)
+			Bits |= Plane [Word + 1] << (KMaskBits - Shift);
+
+		return Bits & ((1ULL << Count) - 1);
+
+	}// GetPlaneBits ()
+
+	/**
+	* \fn SetPlaneBits (unsigned long long* Plane, const unsigned& Offset, const unsigned& Count, const unsigned long long& Bits)
+	* \brief function to write Count bits of a plane from the bit Offset, Count being less than KMaskBits.
+	*/
+	inline void SetPlaneBits (unsigned long long* Plane, const unsigned& Offset, const unsigned& Count, const unsigned long long& Bits)
+	{
+		const unsigned Word  = Offset / KMaskBits;
+		const unsigned Shift = Offset % KMaskBits;
+		const unsigned long long Mask = (1ULL << Count) - 1;
+
+		Plane [Word] = (Plane [Word] & ~(Mask << Shift)) | (Bits << Shift);
+		if (Shift + Count > KMaskBits)
+			Plane [Word + 1] = (Plane [Word + 1] & ~(Mask >> (KMaskBits - Shift))) | (Bits >> (KMaskBits - Shift));
+
+	}// SetPlaneBits ()
+
+	/**
+	* \fn unsigned long long : CompactBits (unsigned long long Value, const unsigned long long& Removed)
+	* \brief function to remove the bits of Value selected by Removed, the bits above them moving down : PEXT (Value, ~Removed).
+	*
+	* Without BMI2, each block of consecutive removed bits is taken out at once, from the highest;
+	* the bit 63 must not be removed.
+	*/
+	inline unsigned long long CompactBits (unsigned long long Value, const unsigned long long& Removed)
+	{
+#if defined (NUMBERCRUSH_X86) && defined (__BMI2__)
+		return _pext_u64 (Value, ~Removed);
+#else
+		for (unsigned long long Bits = Removed; Bits; )
+		{
+			const unsigned Top = KMaskBits - 1 - __builtin_clzll (Bits);
+			const unsigned long long Kept = ~Bits & ((1ULL << Top) - 1);
+			const unsigned Low = Kept ? KMaskBits - __builtin_clzll (Kept) : 0;
+			const unsigned long long Below = (1ULL << Low) - 1;
+
+			Value = (Value & Below) | ((Value >> (Top + 1 - Low)) & ~Below);
+			Bits &= Below;
+		}
+
+		return Value;
+#endif
+	}// CompactBits ()
+
+	/** \class CBitBoard
+	 *
+	 * \brief the matrix stored as one bitboard per number, for the matrices of at most KBitWords * KMaskBits cells
+	 *
+	 * The cells are stored column after column, the bottom row first : a sequence in a column
+	 * is found by shifting a plane by 1, a sequence in a row by shifting it by the stride.
+	 * A padding bit, always 0, follows the top row of each column and stops the sequences.
+	 * The cell of the row i and the column j, border excluded, is the bit (j - 1) * stride + heigth - i.
+	 * A special cell is set in the plane of its number and in the plane of its kind.
+	 *
+	 */
+	class CBitBoard
+	{
+		unsigned long long	m_Planes [KBitCandies][KBitWords];	/*!< \brief m_Planes [k] holds the cells of the number '1' + k */
+		unsigned long long	m_Kinds [KSpecialColor][KBitWords];	/*!< \brief m_Kinds [k] holds the special cells of the kind k + 1, @see CellKind */
+		unsigned			m_Heigth;		/*!< \brief number of rows, border excluded */
+		unsigned			m_Width;		/*!< \brief number of columns, border excluded */
+		unsigned			m_NbCandies;	/*!< \brief how many planes are used */
+		unsigned			m_NbWords;		/*!< \brief how many words of each plane are used */
+
+	  public:
+		CBitBoard () : m_Heigth (0), m_Width (0), m_NbCandies (0), m_NbWords (0) {}
+
+		/**
+		* \fn bool : Fits (const unsigned& Heigth, const unsigned& Width, const unsigned& NbCandies)
+		* \brief function to test if a matrix, border excluded, can be stored in a CBitBoard.
+		*/
+		static bool Fits (const unsigned& Heigth, const unsigned& Width, const unsigned& NbCandies)
+		{
+			return NbCandies <= KBitCandies && Width <= KMaxBitColumns && Heigth + 1 < KMaskBits
+				&& Width * (Heigth + 1) <= KBitWords * KMaskBits;
+		}
+
+		unsigned GetHeigth		() const { return m_Heigth; }
+		unsigned GetWidth		() const { return m_Width; }
+		unsigned GetStride		() const { return m_Heigth + 1; }
+		unsigned GetNbCandies	() const { return m_NbCandies; }
+		unsigned GetNbWords		() const { return m_NbWords; }
+
+		unsigned long long*			GetPlane (const unsigned& k)		{ return m_Planes [k]; }
+		const unsigned long long*	GetPlane (const unsigned& k) const	{ return m_Planes [k]; }
+		unsigned long long*			GetKinds (const unsigned& k)		{ return m_Kinds [k]; }
+		const unsigned long long*	GetKinds (const unsigned& k) const	{ return m_Kinds [k]; }
+
+		/**
+		* \fn unsigned : Index (const unsigned& Row, const unsigned& Col) const
+		* \brief function to get the bit of a cell of the CBoard, @see CBitBoard.
+		*/
+		unsigned Index (const unsigned& Row, const unsigned& Col) const { return (Col - 1) * GetStride () + m_Heigth - Row; }
+
+		/**
+		* \fn FromBoard (const CBoard& Grid, const unsigned& NbCandies)
+		* \brief function to build the planes from a matrix, which must fit.
+		*/
+		void FromBoard (const CBoard& Grid, const unsigned& NbCandies)
+		{
+			m_Heigth	= Grid.GetHeigth () - 2;
+			m_Width		= Grid.GetWidth () - 2;
+			m_NbCandies	= NbCandies;
+			m_NbWords	= (m_Width * GetStride () + KMaskBits - 1) / KMaskBits;
+			fill (&m_Planes [0][0], &m_Planes [0][0] + KBitCandies * KBitWords, 0ULL);
+			fill (&m_Kinds [0][0], &m_Kinds [0][0] + KSpecialColor * KBitWords, 0ULL);
+
+			for (unsigned i (1); i <= m_Heigth; ++i)
+				for (unsigned j (1); j <= m_Width; ++j)
+				{
+					const unsigned k = CellColor (Grid [i][j]) - 1;
+					const unsigned Kind = CellKind (Grid [i][j]);
+					const unsigned Bit = Index (i, j);
+					if (k < m_NbCandies)
+						m_Planes [k][Bit / KMaskBits] |= 1ULL << (Bit % KMaskBits);
+					if (k < m_NbCandies && Kind)
+						m_Kinds [Kind - 1][Bit / KMaskBits] |= 1ULL << (Bit % KMaskBits);
+				}
+		}
+
+		/**
+		* \fn char : Get (const unsigned& Row, const unsigned& Col) const
+		* \brief function to get the cell, KImpossible if it is empty, @see MakeSpecial.
+		*/
+		char Get (const unsigned& Row, const unsigned& Col) const
+		{
+			const unsigned Bit = Index (Row, Col);
+			for (unsigned k (0); k < m_NbCandies; ++k)
+				if ((m_Planes [k][Bit / KMaskBits] >> (Bit % KMaskBits)) & 1ULL)
+				{
+					for (unsigned Kind (0); Kind < KSpecialColor; ++Kind)
+						if ((m_Kinds [Kind][Bit / KMaskBits] >> (Bit % KMaskBits)) & 1ULL)
+							return MakeSpecial (char ('1' + k), Kind + 1);
+					return char ('1' + k);
+				}
+
+			return KImpossible;
+		}
+
+		/**
+		* \fn Set (const unsigned& Row, const unsigned& Col, const char& Cell)
+		* \brief function to set a cell of the CBoard, KImpossible to empty it, @see Get.
+		*/
+		void Set (const unsigned& Row, const unsigned& Col, const char& Cell)
+		{
+			const unsigned Bit = Index (Row, Col), Word = Bit / KMaskBits;
+			const unsigned long long One = 1ULL << (Bit % KMaskBits);
+			for (unsigned k (0); k < m_NbCandies; ++k)
+				m_Planes [k][Word] &= ~One;
+			for (unsigned Kind (0); Kind < KSpecialColor; ++Kind)
+				m_Kinds [Kind][Word] &= ~One;
+
+			const unsigned Color = CellColor (Cell), Kind = CellKind (Cell);
+			if (0 == Color || Color > m_NbCandies) return;
+
+			m_Planes [Color - 1][Word] |= One;
+			if (Kind)
+				m_Kinds [Kind - 1][Word] |= One;
+		}
+
+		/**
+		* \fn Swap (const CPosition& A, const CPosition& B)
+		* \brief function to swap two cells, like MakeAMove.
+		*/
+		void Swap (const CPosition& A, const CPosition& B)
+		{
+			const unsigned BitA = Index (A.first, A.second), BitB = Index (B.first, B.second);
+			for (unsigned k (0); k < m_NbCandies + KSpecialColor; ++k)
+			{
+				unsigned long long* Plane = (k < m_NbCandies) ? m_Planes [k] : m_Kinds [k - m_NbCandies];
+				if (((Plane [BitA / KMaskBits] >> (BitA % KMaskBits)) & 1ULL) == ((Plane [BitB / KMaskBits] >> (BitB % KMaskBits)) & 1ULL))
+					continue;
+
+				Plane [BitA / KMaskBits] ^= 1ULL << (BitA % KMaskBits);
+				Plane [BitB / KMaskBits] ^= 1ULL << (BitB % KMaskBits);
+			}
+		}
+
+	};// CBitBoard
+
+	/** \struct CGameConfig
+	 *
+	 * \brief the settings of a game, read from the config file
+	 *
+	 */
+	struct CGameConfig
+	{
+		unsigned	MatHeigth;	/*!< \brief number of rows, border excluded */
+		unsigned	MatWidth;	/*!< \brief number of columns, border excluded */
+		unsigned	NbCandies;	/*!< \brief how many different numbers are played */
+		unsigned	NbMaxTimes;	/*!< \brief how many moves the player has */
+		bool		IsBitBoard;	/*!< \brief play with a CBitBoard when the matrix fits in it */
+		bool		IsSpecials;	/*!< \brief the sequences of 4, 5 and in L or T make special cells */
+	};
+
+	/** \struct CTurnScratch
+	 *
+	 * \brief the buffers of a game reused by every move, sized once by InitTurnScratch
+	 *
+	 */
+	struct CTurnScratch
+	{
+		CVRun	VRuns;		/*!< \brief sequences found by the current step of the cascade */
+		CVUInt	VFrom;		/*!< \brief first dirty column of each row, 0 when the row is clean */
+		CVUInt	VTo;		/*!< \brief last dirty column of each row */
+		CVLine	VCells;		/*!< \brief the cells shuffled by ShuffleGrid */
+		CMask	Cleared;	/*!< \brief the cells belonging to a sequence */
+		CMask	Removed;	/*!< \brief the cells removed by the current step of a cascade, all 0 between two steps */
+		CMask	Crossed;	/*!< \brief the cells shared by two sequences of the current step, all 0 between two steps */
+		CVUInt	VRemoved;	/*!< \brief the cells of Removed, in the order they were added */
+		CVUInt	VCrossings;	/*!< \brief the cells of Crossed */
+		CVCellChange VSpecials;	/*!< \brief the special cells made by the current step and where they go */
+	};
+
+	/** \struct CRules
+	 *
+	 * \brief the core rules instantiated for one CShape, @see ShapeRules, SelectRules
+	 *
+	 */
+	struct CRules
+	{
+		bool (*IsMatchingMove)		(const CBoard&, const CPosition&, const char&);/*!< \brief @see IsMatchingMove */
+		void (*ListMatchingMoves)	(const CBoard&, CVMove&);/*!< \brief @see ListMatchingMoves */
+		bool (*FindHint)			(const CBoard&, CMove&);/*!< \brief @see FindHint */
+		void (*ResolveCascade)		(CBoard&, const CVLine&, CRandom&, CDirtyRegion&, CTurnScratch&,
+									 unsigned&, unsigned&, const CPosition*, CUndoLog*, CVUInt*);/*!< \brief @see ResolveCascade */
+	};
+
+	/** \struct CGame
+	 *
+	 * \brief the state of a game, independent of any display or input
+	 *
+	 */
+	struct CGame
+	{
+		CBoard			Grid;			/*!< \brief the matrix, with its border */
+		CVLine			VCandies;		/*!< \brief the numbers used to fill the matrix */
+		CDirtyRegion	Dirty;			/*!< \brief the cells changed by the current move */
+		CTurnScratch	Scratch;		/*!< \brief buffers of the moves, so that a move does not allocate */
+		const CRules*	Rules;			/*!< \brief the rules specialized for the size of the matrix, set by InitGame */
+		unsigned		TotalScore;		/*!< \brief score of the game */
+		unsigned		TurnScore;		/*!< \brief score of the last move, before the multiplier */
+		unsigned		Multiplier;		/*!< \brief number of sequences removed by the last move */
+		unsigned		NbMovesLeft;	/*!< \brief how many moves are left */
+		CRandom			Random;			/*!< \brief generator of the numbers refilling the matrix */
+		CBitBoard		Bits;			/*!< \brief the matrix as bitboards, when IsBitBoard */
+		bool			IsBitBoard;		/*!< \brief the cascades are resolved on Bits, then copied to Grid */
+		bool			IsSpecials;		/*!< \brief the moves make special cells, @see ClearRuns */
+		bool			IsShuffled;		/*!< \brief the matrix was shuffled after the last move, no move could make a sequence */
+	};
+	/** \struct CReplay
+	 *
+	 * \brief what is needed to play a game again : its seed, its settings and the moves of the player
+	 *
+	 */
+	struct CReplay
+	{
+		unsigned long long	Seed;		/*!< \brief seed of the game, @see InitGame */
+		CGameConfig			Config;		/*!< \brief settings of the game */
+		CVMove				VMoves;		/*!< \brief the moves, in order */
+		unsigned			TotalScore;	/*!< \brief final score of the game */
+	};
+	/** \struct CSession
+	 *
+	 * \brief a slot of the server : a client and its game, reused by the next client once it leaves
+	 *
+	 */
+	struct CSession
+	{
+		int			Socket;		/*!< \brief socket of the client, -1 when the slot is free */
+		CGame		Game;		/*!< \brief the game of the client */
+		string		Input;		/*!< \brief what the client sent after its last complete line */
+		string		Output;		/*!< \brief what is left to send to the client */
+		bool		IsWriting;	/*!< \brief the server waits for the socket to accept Output */
+		bool		IsClosing;	/*!< \brief the client asked to leave : the slot is freed once Output is sent */
+	};
+	/** \struct CLoadClient
+	 *
+	 * \brief a client of LoadTest, playing the hints of the server
+	 *
+	 */
+	struct CLoadClient
+	{
+		int		Socket;		/*!< \brief socket of the client, -1 once its game is over */
+		string	Input;		/*!< \brief what the server sent after its last complete line */
+		chrono::steady_clock::time_point MoveTime;	/*!< \brief when the last move was sent */
+	};
+	/** \struct CScoreRecord
+	 *
+	 * \brief the result of a game, as recorded in the log of the scores
+	 *
+	 */
+	struct CScoreRecord
+	{
+		string				Player;		/*!< \brief name of the player, KScoreNameSize bytes at most */
+		CGameConfig			Config;		/*!< \brief settings of the game */
+		unsigned			TotalScore;	/*!< \brief final score */
+		unsigned			NbMoves;	/*!< \brief moves played */
+		unsigned long long	Seed;		/*!< \brief seed of the game, @see InitGame */
+		unsigned long long	Date;		/*!< \brief end of the game, in seconds since 1970 */
+	};
+	typedef vector <CScoreRecord>		CVScoreRecord;/*!< \brief a type representing a list of results */
+	/** \struct CScoreEntry
+	 *
+	 * \brief a record of the log of the scores, as sorted in its index
+	 *
+	 */
+	struct CScoreEntry
+	{
+		unsigned long long	Config;	/*!< \brief the settings of the game, @see ScoreConfigKey */
+		unsigned			Score;	/*!< \brief final score */
+		unsigned			Record;	/*!< \brief number of the record in the log, the first being 0 */
+	};
+	typedef vector <CScoreEntry>		CVScoreEntry;/*!< \brief a type representing a list of entries of the index */
+	/** \struct CScoreIndexHeader
+	 *
+	 * \brief the beginning of the index of the scores, followed by its entries by settings then by score
+	 *
+	 */
+	struct CScoreIndexHeader
+	{
+		unsigned long long	Magic;		/*!< \brief KScoreIndexMagic */
+		unsigned			NbEntries;	/*!< \brief the first records of the log the index holds */
+		unsigned			EntrySize;	/*!< \brief sizeof (CScoreEntry), an index of another build being rebuilt */
+	};
+	typedef function <bool (const CGame&, CPosition&, char&)> CMovePolicy;/*!< \brief a type representing a player : gives the next move, false to give up */
+
+					/**
+					* \fn bool : ReportTest (const string& Name, const unsigned& NbErrors)
+					* \brief function to show the errors of a test function, which returns the result, @see RunTests.
+					*
+					*\return true if there is no error
+					*/
+					bool ReportTest (const string& Name, const unsigned& NbErrors)
+					{
+						cout << Name << " : " << NbErrors << " erreur(s)" << endl;
+						return 0 == NbErrors;
+
+					}// ReportTest ()
+
+					/**
+					* \fn CGameConfig : MakeTestConfig (const unsigned& Heigth, const unsigned& Width, const unsigned& NbCandies, const unsigned& NbMaxTimes, const bool& IsSpecials)
+					* \brief function to get the settings of a game of a test function, played without CBitBoard.
+					*/
+					CGameConfig MakeTestConfig (const unsigned& Heigth, const unsigned& Width, const unsigned& NbCandies, const unsigned& NbMaxTimes, const bool& IsSpecials)
+					{
+						CGameConfig Config;
+						Config.MatHeigth	= Heigth;
+						Config.MatWidth		= Width;
+						Config.NbCandies	= NbCandies;
+						Config.NbMaxTimes	= NbMaxTimes;
+						Config.IsBitBoard	= false;
+						Config.IsSpecials	= IsSpecials;
+
+						return Config;
+
+					}// MakeTestConfig ()
 
 	/**
 	* \fn ClearScreen ()
@@ -208,85 +1194,551 @@ namespace nsNumberCrush
 	}// ShowScore ()
 
 	/**
-	* \fn DisplayGrid (const CMat& Grid)
-	* \brief function to show the matrix on screen.
-	*\param Grid : name of the matrix
+	* \fn AppendUInt (string& Frame, unsigned Value)
+	* \brief function to write a number at the end of a frame, without stream.
 	*/
-	void DisplayGrid (const CMat& Grid)	//show matrix on screen
+	void AppendUInt (string& Frame, unsigned Value)
 	{
-		Color (KReset);
-		
-		for (unsigned i (1); i < Grid [0].size () - 1; ++i)
-			cout << "  " << i << " ";
-		cout << endl;
-
-		for (unsigned i (0); i < Grid [0].size () - 2; ++i)
-			cout << "____";
-		cout << endl;
-
-		for (unsigned i (1); i < Grid.size () - 1; ++i)
+		char Digits [10];
+		unsigned NbDigits (0);
+		do
 		{
-			for (unsigned j (0); j < Grid [i].size () - 2; ++j)
-				cout << "|   ";
-			cout << "|" << endl;
+			Digits [NbDigits++] = char ('0' + Value % 10);
+			Value /= 10;
+		} while (Value);
 
-			cout << "| ";
-			for (unsigned j (1); j < Grid [i].size () - 1; ++j)
-			{
-				(KImpossible != Grid [i][j]) ? cout << Grid [i][j]
-											 : cout << " ";
-				cout << " | ";
-			}
-			cout << setw (3) << i << endl;
-
-			for (unsigned j (0); j < Grid [i].size () - 2; ++j)
-				cout << "|___";
-			cout << "|" << endl;
-		}
+		for ( ; NbDigits; )
+			Frame += Digits [--NbDigits];
 
-	}// DisplayGrid ()
+	}// AppendUInt ()
 
 	/**
-	* \fn InitGrid (CMat& Grid, const unsigned& Width, const unsigned& Heigth)
-	* \brief function to create the square matrix.
-	*
-	*\param Grid : Matrix
-	*\param Width : Width of the matrix
-	*\param Heigth : Heigth of the matrix
+	* \fn AppendColor (string& Frame, const string& Col)
+	* \brief function to write a color change at the end of a frame, @see Color.
 	*/
-	void InitGrid (CMat& Grid,
-				   const unsigned& Width,
-				   const unsigned& Heigth)	//Initialize a square matrix
+	void AppendColor (string& Frame, const string& Col)
 	{
-		Grid.resize (Heigth);
-		for (unsigned i (0); i < Grid.size (); ++i)
-			Grid [i].resize (Width);
+		Frame += "\033[";
+		Frame += Col;
+		Frame += 'm';
 
-		for (unsigned i (0); i < Grid.size (); ++i)
-			for (unsigned j (0); j < Grid [i].size (); ++j)
-				Grid [i][j] = KImpossible;
-
-	}// InitGrid ()
+	}// AppendColor ()
 
 	/**
-	* \fn FillGrid (CMat& Grid, const CVLine& Vect)
-	* \brief function to replace 'KImpossibe' values in a matrix by random characters from a vector.
-	*
-	*\param Grid : Matrix
-	*\param Vect : Vector
+	* \fn AppendMoveTo (string& Frame, const unsigned& Row, const unsigned& Col)
+	* \brief function to write a move of the cursor at the end of a frame, the first row and column are 1.
 	*/
-	void FillGrid (CMat& Grid, const CVLine& Vect)	//replace 'KImpossibe' values in a matrix by random characters from a vector
+	void AppendMoveTo (string& Frame, const unsigned& Row, const unsigned& Col)
 	{
-		for (unsigned i (1); i < Grid.size () - 1; ++i)
-			for (unsigned j (1); j < Grid [i].size () - 1; ++j)
-			{
-				if (Grid [i][j] != KImpossible) continue;
+		Frame += "\033[";
+		AppendUInt (Frame, Row);
+		Frame += ';';
+		AppendUInt (Frame, Col);
+		Frame += 'H';
 
-				unsigned RandNb = rand () % Vect.size ();
-				Grid [i][j] = Vect [RandNb];
-			}
-
-	}// FillGrid ()
+	}// AppendMoveTo ()
+
+	/**
+	* \fn const string& : CandyColor (const char& Value)
+	* \brief function to get the color of a number.
+	*/
+	const string& CandyColor (const char& Value)
+	{
+		return KCandyColors [(CellColor (Value) - 1) % KNbCandyColors];
+
+	}// CandyColor ()
+
+	/**
+	* \fn CView : WholeView (const CBoard& Grid)
+	* \brief function to get a view showing the whole matrix.
+	*/
+	inline CView WholeView (const CBoard& Grid)
+	{
+		const CView View = { 1, 1, Grid.GetHeigth () - 2, Grid.GetWidth () - 2 };
+		return View;
+
+	}// WholeView ()
+
+	/**
+	* \fn AppendGrid (string& Frame, const CBoard& Grid, const CView& View)
+	* \brief function to write a view of the matrix at the end of a frame, each number in its color.
+	*
+	* The view takes KCellHeigth lines per row after 2 header lines ; the number of the row i and
+	* the column j is at the column 3 + KCellWidth * (j - View.Left), @see CRenderer.
+	*
+	*\param Frame : the frame
+	*\param Grid : Matrix
+	*\param View : the rows and columns shown
+	*/
+	void AppendGrid (string& Frame, const CBoard& Grid, const CView& View)
+	{
+		const unsigned Bottom = View.Top + View.NbRows;
+		const unsigned Right  = View.Left + View.NbColumns;
+		AppendColor (Frame, KReset);
+
+		//each number of the header ends above the number of its column ; from 1000, a number longer
+		//than a cell is only written when a space is left after the previous one : one column in two
+		unsigned Written (0), Free (0);
+		for (unsigned i (View.Left); i < Right; ++i)
+		{
+			unsigned NbDigits (1);
+			for (unsigned Value (i); Value >= 10; Value /= 10)
+				++NbDigits;
+			const unsigned End = KCellWidth * (i - View.Left) + 3;
+			if (End < Free + NbDigits) continue;
+
+			Frame.append (End - NbDigits - Written, ' ');
+			AppendUInt (Frame, i);
+			Written = End;
+			Free	= End + 1;
+		}
+		Frame.append (KCellWidth * View.NbColumns - Written, ' ');
+		Frame += '\n';
+
+		for (unsigned i (0); i < View.NbColumns; ++i)
+			Frame += "____";
+		Frame += '\n';
+
+		for (unsigned i (View.Top); i < Bottom; ++i)
+		{
+			for (unsigned j (0); j < View.NbColumns; ++j)
+				Frame += "|   ";
+			Frame += "|\n";
+
+			Frame += "| ";
+			for (unsigned j (View.Left); j < Right; ++j)
+			{
+				if (KImpossible != Grid [i][j])
+				{
+					AppendColor (Frame, CandyColor (Grid [i][j]));
+					Frame += char ('0' + CellColor (Grid [i][j]));
+					Frame += KSpecialMarks [CellKind (Grid [i][j])];
+					AppendColor (Frame, KReset);
+				}
+				else
+					Frame += "  ";
+				Frame += "| ";
+			}
+			Frame.append (i < 10 ? 2 : i < 100 ? 1 : 0, ' ');
+			AppendUInt (Frame, i);
+			Frame += '\n';
+
+			for (unsigned j (0); j < View.NbColumns; ++j)
+				Frame += "|___";
+			Frame += "|\n";
+		}
+
+	}// AppendGrid ()
+
+	/**
+	* \fn AppendGrid (string& Frame, const CBoard& Grid)
+	* \brief function to write the whole matrix at the end of a frame, @see WholeView.
+	*/
+	void AppendGrid (string& Frame, const CBoard& Grid)
+	{
+		AppendGrid (Frame, Grid, WholeView (Grid));
+
+	}// AppendGrid ()
+
+	/**
+	* \fn DisplayGrid (const CBoard& Grid)
+	* \brief function to show the matrix on screen.
+	*\param Grid : name of the matrix
+	*/
+	void DisplayGrid (const CBoard& Grid)	//show matrix on screen
+	{
+		string Frame;
+		AppendGrid (Frame, Grid);
+		cout.write (Frame.data (), Frame.size ()).flush ();
+
+	}// DisplayGrid ()
+
+	/** \class CRenderer
+	 *
+	 * \brief the screen of a game, drawn frame by frame
+	 *
+	 * A frame is built in one buffer, allocated once, and sent with a single write.
+	 * The first frame clears the screen and draws everything ; the next ones only
+	 * move the cursor to the numbers that changed since the previous frame and
+	 * rewrite the score, the number of moves left and the status line.
+	 * A large board is shown through a view of KViewRows x KViewColumns cells, with its
+	 * coordinates : only the cells of the view are drawn and kept for the next frame.
+	 *
+	 */
+	class CRenderer
+	{
+		string		m_Frame;		/*!< \brief the frame being built */
+		CView		m_View;			/*!< \brief the part of the matrix shown */
+		CVLine		m_VPrevious;	/*!< \brief the cells of the view in the previous frame, row after row */
+		CPosition	m_Size;			/*!< \brief rows and columns of the matrix of the previous frame */
+		bool		m_IsDrawn;		/*!< \brief false until a whole frame is on screen */
+		CVString	m_VFooter;		/*!< \brief the lines shown under the matrix, @see KHelpFileName */
+		string		m_Color;		/*!< \brief the color set at the end of m_Frame */
+		unsigned	m_MovesRow;		/*!< \brief row of the number of moves left */
+		unsigned	m_StatusRow;	/*!< \brief row of the status line */
+		unsigned	m_PromptRow;	/*!< \brief row of the command prompt */
+
+		/**
+		* \fn unsigned : NextRow () const
+		* \brief function to get the row where the next line of a whole frame starts.
+		*/
+		unsigned NextRow () const
+		{
+			return 1 + count (m_Frame.begin (), m_Frame.end (), '\n');
+
+		}// NextRow ()
+
+		/**
+		* \fn SetColor (const string& Col)
+		* \brief function to change the color, only if it is not already set.
+		*/
+		void SetColor (const string& Col)
+		{
+			if (Col == m_Color) return;
+
+			AppendColor (m_Frame, Col);
+			m_Color = Col;
+
+		}// SetColor ()
+
+		/**
+		* \fn AppendLine (const unsigned& Row, const char* Label, const unsigned& Value)
+		* \brief function to rewrite a whole line : a label and a number.
+		*/
+		void AppendLine (const unsigned& Row, const char* Label, const unsigned& Value)
+		{
+			AppendMoveTo (m_Frame, Row, 1);
+			m_Frame += Label;
+			AppendUInt (m_Frame, Value);
+			m_Frame += "\033[K";
+
+		}// AppendLine ()
+
+		/**
+		* \fn AppendFull (const CGame& Game, const CBoard& Grid, const string& Status)
+		* \brief function to build a frame drawing the whole screen.
+		*/
+		void AppendFull (const CGame& Game, const CBoard& Grid, const string& Status)
+		{
+			m_Frame += "\033[H\033[2J";
+			AppendColor (m_Frame, KReset);
+
+			m_Frame += "Score : ";
+			AppendUInt (m_Frame, Game.TotalScore);
+			m_Frame += "\n+";
+			AppendUInt (m_Frame, Game.TurnScore);
+			m_Frame += "\nx";
+			AppendUInt (m_Frame, Game.Multiplier);
+			m_Frame += '\n';
+			if (IsLargeBoard (Grid))
+			{
+				m_Frame += "Lignes ";
+				AppendUInt (m_Frame, m_View.Top);
+				m_Frame += " a ";
+				AppendUInt (m_Frame, m_View.Top + m_View.NbRows - 1);
+				m_Frame += " sur ";
+				AppendUInt (m_Frame, Grid.GetHeigth () - 2);
+				m_Frame += ", colonnes ";
+				AppendUInt (m_Frame, m_View.Left);
+				m_Frame += " a ";
+				AppendUInt (m_Frame, m_View.Left + m_View.NbColumns - 1);
+				m_Frame += " sur ";
+				AppendUInt (m_Frame, Grid.GetWidth () - 2);
+			}
+			m_Frame += '\n';
+
+			AppendGrid (m_Frame, Grid, m_View);
+
+			m_MovesRow = NextRow ();
+			m_Frame += "Nombre de coups restant : ";
+			AppendUInt (m_Frame, Game.NbMovesLeft);
+			m_Frame += "\n\n";
+
+			m_StatusRow = NextRow ();
+			m_Frame += Status;
+			m_Frame += "\n\n";
+
+			for (unsigned i (0); i < m_VFooter.size (); ++i)
+			{
+				m_Frame += m_VFooter [i];
+				m_Frame += '\n';
+			}
+			m_Frame += '\n';
+
+			m_PromptRow = NextRow ();
+			m_Frame += "Entrez une commande : ";
+			m_Color = KReset;
+
+		}// AppendFull ()
+
+		/**
+		* \fn AppendChanges (const CGame& Game, const CBoard& Grid, const string& Status)
+		* \brief function to build a frame drawing only what changed since the previous one.
+		*/
+		void AppendChanges (const CGame& Game, const CBoard& Grid, const string& Status)
+		{
+			AppendLine (1, "Score : ", Game.TotalScore);
+			AppendLine (2, "+", Game.TurnScore);
+			AppendLine (3, "x", Game.Multiplier);
+
+			for (unsigned i (0); i < m_View.NbRows; ++i)
+			{
+				const char* Row		= Grid [m_View.Top + i] + m_View.Left;
+				const char* Before	= &m_VPrevious [i * m_View.NbColumns];
+				for (unsigned j (0); j < m_View.NbColumns; ++j)
+				{
+					if (Row [j] == Before [j]) continue;
+
+					AppendMoveTo (m_Frame, KGridTop + KCellHeigth * (i + 1), 3 + KCellWidth * j);
+					if (KImpossible != Row [j])
+					{
+						SetColor (CandyColor (Row [j]));
+						m_Frame += char ('0' + CellColor (Row [j]));
+						m_Frame += KSpecialMarks [CellKind (Row [j])];
+					}
+					else
+						m_Frame += "  ";
+				}
+			}
+			SetColor (KReset);
+
+			AppendLine (m_MovesRow, "Nombre de coups restant : ", Game.NbMovesLeft);
+
+			AppendMoveTo (m_Frame, m_StatusRow, 1);
+			m_Frame += Status;
+			m_Frame += "\033[K";
+
+			AppendMoveTo (m_Frame, m_PromptRow, 1);
+			m_Frame += "\033[JEntrez une commande : ";
+
+		}// AppendChanges ()
+
+	  public:
+		explicit CRenderer (const CVString& VFooter = CVString ())
+			: m_Size (0, 0), m_IsDrawn (false), m_VFooter (VFooter), m_MovesRow (0), m_StatusRow (0), m_PromptRow (0)
+		{
+			m_Frame.reserve (KFrameCapacity);
+			m_View.Top = m_View.Left = 1;
+			m_View.NbRows = m_View.NbColumns = 0;
+		}
+
+		/**
+		* \fn CenterView (const CBoard& Grid, const CPosition& Center)
+		* \brief function to move the view of a large board around a cell, the whole screen being drawn at the next frame.
+		*/
+		void CenterView (const CBoard& Grid, const CPosition& Center)
+		{
+			m_View.NbRows		= min (Grid.GetHeigth () - 2, KViewRows);
+			m_View.NbColumns	= min (Grid.GetWidth () - 2, KViewColumns);
+			m_View.Top	= min (max (Center.first, 1u + m_View.NbRows / 2) - m_View.NbRows / 2, Grid.GetHeigth () - 1 - m_View.NbRows);
+			m_View.Left	= min (max (Center.second, 1u + m_View.NbColumns / 2) - m_View.NbColumns / 2, Grid.GetWidth () - 1 - m_View.NbColumns);
+			m_IsDrawn	= false;
+
+		}// CenterView ()
+
+		/**
+		* \fn Invalidate ()
+		* \brief function to draw the whole screen at the next frame.
+		*/
+		void Invalidate () { m_IsDrawn = false; }
+
+		/**
+		* \fn Draw (const CGame& Game, const CBoard& Grid, const string& Status)
+		* \brief function to show a game on screen with a single write.
+		*
+		*\param Game : the game
+		*\param Grid : the matrix to show instead of the one of the game
+		*\param Status : a message shown under the number of moves left
+		*/
+		void Draw (const CGame& Game, const CBoard& Grid, const string& Status)
+		{
+			CPhaseClock Clock (KPhaseRender);
+			m_Frame.clear ();
+
+			if (m_Size != CPosition (Grid.GetHeigth (), Grid.GetWidth ()))
+			{
+				m_Size = CPosition (Grid.GetHeigth (), Grid.GetWidth ());
+				CenterView (Grid, CPosition (0, 0));
+			}
+			if (!m_IsDrawn)
+				AppendFull (Game, Grid, Status);
+			else
+				AppendChanges (Game, Grid, Status);
+
+			cout.write (m_Frame.data (), m_Frame.size ()).flush ();
+			m_VPrevious.resize (m_View.NbRows * m_View.NbColumns);
+			for (unsigned i (0); i < m_View.NbRows; ++i)
+				copy (Grid [m_View.Top + i] + m_View.Left, Grid [m_View.Top + i] + m_View.Left + m_View.NbColumns,
+					  m_VPrevious.begin () + i * m_View.NbColumns);
+			m_IsDrawn	= true;
+
+		}// Draw ()
+
+		/**
+		* \fn Draw (const CGame& Game, const string& Status)
+		* \brief function to show a game on screen with a single write.
+		*/
+		void Draw (const CGame& Game, const string& Status) { Draw (Game, Game.Grid, Status); }
+
+	};// CRenderer
+
+	/** \class CAnimation
+	 *
+	 * \brief the playback of a move, step by step : swap, removals, fall, refill
+	 *
+	 * The move is already resolved when the playback starts : its steps are rebuilt
+	 * from the undo log as frame deltas, then shown at a fixed frame rate. Tick ()
+	 * never waits ; when the display falls behind, the late frames are dropped and
+	 * the last due one is shown.
+	 *
+	 */
+	class CAnimation
+	{
+		CBoard							m_Grid;		/*!< \brief the matrix of the last shown frame */
+		CVCellChange					m_VDeltas;	/*!< \brief the new value of each changed cell, in order */
+		CVUInt							m_VSteps;	/*!< \brief end of each frame in m_VDeltas */
+		unsigned						m_NbShown;	/*!< \brief how many frames are shown */
+		chrono::steady_clock::duration	m_Period;	/*!< \brief time between two frames */
+		chrono::steady_clock::time_point	m_Start;	/*!< \brief when the first frame is due */
+
+	  public:
+		explicit CAnimation (const unsigned& Fps)
+			: m_NbShown (0), m_Period (chrono::duration_cast <chrono::steady_clock::duration> (chrono::microseconds (1000000 / max (Fps, 1u)))) {}
+
+		/**
+		* \fn Start (const CBoard& Grid, const CUndoLog& Log, const unsigned& Checkpoint, const CVUInt& VSteps)
+		* \brief function to start the playback of the changes recorded since a checkpoint.
+		*
+		*\param Grid : the matrix after the changes
+		*\param Log : the changes
+		*\param Checkpoint : checkpoint of Log before the changes
+		*\param VSteps : the checkpoint of Log at the end of each step
+		*/
+		void Start (const CBoard& Grid, const CUndoLog& Log, const unsigned& Checkpoint, const CVUInt& VSteps)
+		{
+			//walk the log back : the value replaced by a change is its new value
+			m_Grid = Grid;
+			char* Cells = m_Grid.GetData ();
+			m_VDeltas.resize (Log.GetCheckpoint () - Checkpoint);
+			for (unsigned i (Log.GetCheckpoint ()); i-- > Checkpoint; )
+			{
+				const CCellChange& Change = Log [i];
+				m_VDeltas [i - Checkpoint].Offset = Change.Offset;
+				m_VDeltas [i - Checkpoint].Value  = Cells [Change.Offset];
+				Cells [Change.Offset] = Change.Value;
+			}
+
+			m_VSteps.clear ();
+			for (unsigned i (0); i < VSteps.size (); ++i)
+				if (VSteps [i] > Checkpoint)
+					m_VSteps.push_back (VSteps [i] - Checkpoint);
+
+			m_NbShown = 0;
+			m_Start   = chrono::steady_clock::now ();
+
+		}// Start ()
+
+		/**
+		* \fn bool : IsPlaying () const
+		* \brief function to know if a frame is left to show.
+		*/
+		bool IsPlaying () const { return m_NbShown < m_VSteps.size (); }
+
+		/**
+		* \fn chrono::steady_clock::time_point : GetDeadline () const
+		* \brief function to get when the next frame is due.
+		*/
+		chrono::steady_clock::time_point GetDeadline () const { return m_Start + m_Period * m_NbShown; }
+
+		/**
+		* \fn bool : Tick (CRenderer& Renderer, const CGame& Game)
+		* \brief function to show the last due frame, if any, without waiting ; false when the playback is over.
+		*/
+		bool Tick (CRenderer& Renderer, const CGame& Game)
+		{
+			if (!IsPlaying ()) return false;
+
+			const chrono::steady_clock::duration Elapsed = chrono::steady_clock::now () - m_Start;
+			if (Elapsed < m_Period * m_NbShown) return true;
+
+			const unsigned Due = min <unsigned long long> (m_VSteps.size (), Elapsed / m_Period + 1);
+			char* Cells = m_Grid.GetData ();
+			for (unsigned i (m_NbShown ? m_VSteps [m_NbShown - 1] : 0); i < m_VSteps [Due - 1]; ++i)
+				Cells [m_VDeltas [i].Offset] = m_VDeltas [i].Value;
+			m_NbShown = Due;
+
+			Renderer.Draw (Game, m_Grid, "");
+			return IsPlaying ();
+
+		}// Tick ()
+
+	};// CAnimation
+
+	/**
+	* \fn InitGrid (CBoard& Grid, const unsigned& Width, const unsigned& Heigth)
+	* \brief function to create the square matrix.
+	*
+	*\param Grid : Matrix
+	*\param Width : Width of the matrix
+	*\param Heigth : Heigth of the matrix
+	*/
+	void InitGrid (CBoard& Grid,
+				   const unsigned& Width,
+				   const unsigned& Heigth)	//Initialize a square matrix
+	{
+		Grid.Resize (Heigth, Width);
+
+	}// InitGrid ()
+
+	/**
+	* \fn FillGrid (CBoard& Grid, const CVLine& Vect, CRandom& Random, CUndoLog* Log = NULL)
+	* \brief function to replace 'KImpossibe' values in a matrix by random characters from a vector.
+	*
+	*\param Grid : Matrix
+	*\param Vect : Vector
+	*\param Random : random generator
+	*\param Log : records the filled cells, if not NULL
+	*/
+	void FillGrid (CBoard& Grid, const CVLine& Vect, CRandom& Random, CUndoLog* Log = NULL)	//replace 'KImpossibe' values in a matrix by random characters from a vector
+	{
+		CPhaseClock Clock (KPhaseFill);
+		for (unsigned i (1); i < Grid.GetHeigth () - 1; ++i)
+			for (unsigned j (1); j < Grid.GetWidth () - 1; ++j)
+			{
+				if (Grid [i][j] != KImpossible) continue;
+
+				LogCell (Log, Grid, Grid [i][j]);
+				unsigned RandNb = Random.Next (Vect.size ());
+				Grid [i][j] = Vect [RandNb];
+			}
+
+	}// FillGrid ()
+
+	/**
+	* \fn FillGrid (CBoard& Grid, const CVLine& Vect, CRandom& Random, const CVUInt& VNbEmpty, CUndoLog* Log = NULL)
+	* \brief function to replace the empty cells left at the top of each column by random characters from a vector.
+	*
+	*\param Grid : Matrix
+	*\param Vect : Vector
+	*\param Random : random generator
+	*\param VNbEmpty : how many empty cells are at the top of each column, @see MoveNumbersDown
+	*\param Log : records the filled cells, if not NULL
+	*/
+	void FillGrid (CBoard& Grid, const CVLine& Vect, CRandom& Random, const CVUInt& VNbEmpty, CUndoLog* Log = NULL)	//refill the top of the columns
+	{
+		CPhaseClock Clock (KPhaseFill);
+		for (unsigned j (1); j < Grid.GetWidth () - 1; ++j)
+		{
+			CBoard::CColumn Column = Grid.Column (j);
+			for (unsigned i (1); i <= VNbEmpty [j]; ++i)
+			{
+				LogCell (Log, Grid, Column [i]);
+				unsigned RandNb = Random.Next (Vect.size ());
+				Column [i] = Vect [RandNb];
+			}
+		}
+
+	}// FillGrid ()
 
 	/**
 	* \fn CatchInput (string& Input)
@@ -302,46 +1754,24 @@ namespace nsNumberCrush
 	}// CatchInput ()
 
 	/**
-	* \fn bool : IsValueInGrid (const CMat& Grid, const char& Value)
+	* \fn bool : IsValueInGrid (const CBoard& Grid, const char& Value)
 	* \brief function to test if a value is in a matrix.
 	*\param Grid : Matrix
 	*\param Value : Value of a cell
 	*/
-	bool IsValueInGrid (const CMat& Grid, const char& Value)	//test if a value is in a matrix
+	bool IsValueInGrid (const CBoard& Grid, const char& Value)	//test if a value is in a matrix
 	{
-		unsigned i (1);
-		for ( ; i < Grid.size () - 1; )
+		for (unsigned i (1); i < Grid.GetHeigth () - 1; ++i)
 		{
-			unsigned j (1);
-			for ( ; j < Grid [i].size () - 1; )
-			{
-				if (Grid [i][j] == Value) return true;
-				++j;
-			}
-			++i;
+			const char* Row = Grid [i];
+			if (find (Row + 1, Row + Grid.GetWidth () - 1, Value) != Row + Grid.GetWidth () - 1)
+				return true;
 		}
 
 		return false;
 
 	}// IsValueInVect ()
 
-	/**
-	* \fn string : TakeValueInVectStr (const string& Label, const CVString& Vect)
-	* \brief function to catch a value in a vector of string.
-	*\param Label : Value 
-	*\param Vect : Vector of string
-	*/
-	string TakeValueInVectStr (const string& Label, const CVString& Vect)	//Catch a value in a vector of string
-	{
-		string Parser = "=";
-		for(unsigned i (0); i < Vect.size (); ++i)
-		{
-			if(Label == Vect [i].substr (0, Vect [i].find (Parser)))
-				return Vect [i].substr ((Vect [i].find (Parser) + Parser.length ()), Vect [i].length ());
-		}
-
-	}// TakeValueInVectStr ()
-
 	/**
 	* \fn FileToVectStr (CVString& Vect, const string& FileName)
 	* \brief function to translate a file into a vector of string.
@@ -360,50 +1790,161 @@ namespace nsNumberCrush
 
 	}// FileToVectStr ()
 
+	/** \class CConfig
+	 *
+	 * \brief the settings of the game, read once from the config file and cached for the session
+	 *
+	 * Each setting of KConfigKeys has a default value and a range : a missing, unreadable
+	 * or out of range value in the file gives the default one.
+	 *
+	 */
+	class CConfig
+	{
+		string									m_FileName;	/*!< \brief the name of the config file */
+		unordered_map <string, unsigned long long>	m_Values;	/*!< \brief the value of each setting, by label */
+
+		/**
+		* \fn const CConfigKey* : FindKey (const string& Label) const
+		* \brief function to get the description of a setting, NULL if the label is unknown.
+		*/
+		const CConfigKey* FindKey (const string& Label) const
+		{
+			for (unsigned i (0); i < KNbConfigKeys; ++i)
+				if (Label == KConfigKeys [i].Label)
+					return &KConfigKeys [i];
+
+			return NULL;
+
+		}// FindKey ()
+
+	  public:
+		explicit CConfig (const string& FileName = KConfigFileName) : m_FileName (FileName)
+		{
+			for (unsigned i (0); i < KNbConfigKeys; ++i)
+				m_Values [KConfigKeys [i].Label] = KConfigKeys [i].Default;
+		}
+
+		/**
+		* \fn bool : Load ()
+		* \brief function to read the config file, false if it can not be read.
+		*/
+		bool Load ()
+		{
+			if (!IsReadable (m_FileName)) return false;
+
+			CVString VLines;
+			FileToVectStr (VLines, m_FileName);
+			for (unsigned i (0); i < VLines.size (); ++i)
+			{
+				const string& Line = VLines [i];
+				const string::size_type Parser = Line.find ('=');
+				if (string::npos == Parser) continue;
+
+				string Value (Line.substr (Parser + 1));
+				if (!Value.empty () && '\r' == Value [Value.size () - 1])
+					Value.erase (Value.size () - 1);
+
+				if (IsOfType <unsigned long long> (Value))
+					Set (Line.substr (0, Parser), ConvertStr <unsigned long long> (Value));
+			}
+
+			return true;
+
+		}// Load ()
+
+		/**
+		* \fn bool : Save () const
+		* \brief function to write the settings in a temporary file, then rename it to the config file.
+		*
+		* The config file is replaced at once : it is never left half written.
+		*/
+		bool Save () const
+		{
+			const string TmpFileName (m_FileName + ".tmp");
+			{
+				ofstream File (TmpFileName.c_str (), ios_base::out | ios_base::trunc);
+				for (unsigned i (0); i < KNbConfigKeys; ++i)
+					File << KConfigKeys [i].Label << '=' << Get (KConfigKeys [i].Label) << endl;
+
+				if (!File) return false;
+			}
+
+			return 0 == rename (TmpFileName.c_str (), m_FileName.c_str ());
+
+		}// Save ()
+
+		/**
+		* \fn unsigned long long : Get (const string& Label) const
+		* \brief function to get the value of a setting, 0 if the label is unknown.
+		*/
+		unsigned long long Get (const string& Label) const
+		{
+			unordered_map <string, unsigned long long>::const_iterator It = m_Values.find (Label);
+			return m_Values.end () == It ? 0 : It->second;
+
+		}// Get ()
+
+		/**
+		* \fn bool : Set (const string& Label, const unsigned long long& Value)
+		* \brief function to change the value of a setting, false if the label is unknown or the value out of range.
+		*/
+		bool Set (const string& Label, const unsigned long long& Value)
+		{
+			const CConfigKey* Key = FindKey (Label);
+			if (!Key || !IsBetween (Value, Key->Min, Key->Max)) return false;
+
+			m_Values [Label] = Value;
+			return true;
+
+		}// Set ()
+
+	};// CConfig
+
 	/**
-	* \fn CreateConfigFile ()
-	* \brief function to create a config file with default values.
+	* \fn bool : NextToken (const char*& Cursor, const char*& Begin, const char*& End)
+	* \brief function to find the next word of a C string, without stream.
+	*
+	*\param Cursor : where to start, moved after the word
+	*\param Begin : first character of the word
+	*\param End : character following the word
+	*\return false if there is no word left
 	*/
-	void CreateConfigFile ()	//create config file with default values
+	inline bool NextToken (const char*& Cursor, const char*& Begin, const char*& End)
 	{
-		ofstream ConfigCreated;
-		ConfigCreated.open (KConfigFileName.c_str());
-		ConfigCreated << "MatrixWidth=10" 	<< endl;
-		ConfigCreated << "MatrixHeigth=10"	<< endl;
-		ConfigCreated << "NbCandies=5" 		<< endl;
-		ConfigCreated << "NbMaxTimes=20" 	<< endl;
-		ConfigCreated.close ();
+		for ( ; *Cursor && isspace (*Cursor); )
+			++Cursor;
+		Begin = Cursor;
+		for ( ; *Cursor && !isspace (*Cursor); )
+			++Cursor;
+		End = Cursor;
+
+		return Begin != End;
 
-	}// CreateConfig ()
+	}// NextToken ()
 
 	/**
-	* \fn ChangeValueInFile (const string& Label, const string& FileName, const string& Value)
-	* \brief function to change the value in a file.
-	*\param Label : Label
-	*\param FileName : the name of the file 
-	*\param Value : Value
+	* \fn bool : ParseUInt (const char* Begin, const char* End, unsigned& Value)
+	* \brief function to read a decimal unsigned, without stream.
+	*
+	*\param Value : the number, unchanged if the characters are not a number
+	*\return false if a character is not a digit or if the number is too big
 	*/
-	void ChangeValueInFile (const string& Label, const string& FileName, const string& Value)
+	inline bool ParseUInt (const char* Begin, const char* End, unsigned& Value)
 	{
-		string Parser = "=";
-		CVString VToGetConfig;
-		FileToVectStr (VToGetConfig, FileName);
+		if (Begin == End) return false;
 
-		for (unsigned i (0); i < VToGetConfig.size (); ++i)
+		unsigned long long Result (0);
+		for ( ; Begin != End; ++Begin)
 		{
-			if (Label == VToGetConfig [i].substr (0, VToGetConfig [i].find (Parser)))
-				VToGetConfig [i] = (VToGetConfig [i].substr (0, (VToGetConfig [i].find (Parser) + Parser.length ())) + Value);
+			if (!isdigit (*Begin)) return false;
+			Result = Result * 10 + (*Begin - '0');
+			if (Result > numeric_limits <unsigned>::max ()) return false;
 		}
+		Value = unsigned (Result);
 
-		ofstream Config (FileName.c_str (), ios_base::out | ios_base::trunc);
-		string str;
-		if (Config)
-		{
-			for (unsigned i (0); i < VToGetConfig.size (); ++i)
-				Config << VToGetConfig [i] << endl;
-		}
-		Config.close();
-	}
+		return true;
+
+	}// ParseUInt ()
 
 	/**
 	* \fn CutInputStr (const string& InputStr, CPosition& Pos, char& C)
@@ -414,93 +1955,103 @@ namespace nsNumberCrush
 	*/
 	void CutInputStr (const string& InputStr, CPosition& Pos, char& C)
 	{
-		istringstream iss (InputStr);
+		CPhaseClock Clock (KPhaseParse);
+		const char* Cursor = InputStr.c_str ();
+		const char* Begin;
+		const char* End;
 
-		string Str;
-		iss >> Str;
-		if (IsOfType <unsigned> (Str))
-			Pos.first = ConvertStr <unsigned> (Str);
-		iss >> Str;
-		if (IsOfType <unsigned> (Str))
-			Pos.second = ConvertStr <unsigned> (Str);
-		iss >> Str;
-		C = char (toupper (ConvertStr <char> (Str)));
+		if (NextToken (Cursor, Begin, End))
+			ParseUInt (Begin, End, Pos.first);
+		if (NextToken (Cursor, Begin, End))
+			ParseUInt (Begin, End, Pos.second);
+		C = NextToken (Cursor, Begin, End) ? char (toupper (*Begin)) : '\0';
 
 	}// CutInputStr ()
 					/**
-					* \fn Test_CutInputStr ()
+					* \fn bool : Test_CutInputStr ()
 					* \brief test function @see CutInputStr.
 					*/
-					void Test_CutInputStr ()
+					bool Test_CutInputStr ()
 					{
 						string str = "11   12  z";
 						CPosition pos;
 						char c;
 
+						unsigned NbErrors (0);
 						CutInputStr (str, pos, c);
-						cout << pos.first << "/" << pos.second << "/" << c << endl;
+						if (CPosition (11, 12) != pos || 'Z' != c) ++NbErrors;
 
 						str = "9     42   a";
 						CutInputStr (str, pos, c);
-						cout << pos.first << "/" << pos.second << "/" << c << endl;
+						if (CPosition (9, 42) != pos || 'A' != c) ++NbErrors;
+
+						return ReportTest ("Test_CutInputStr", NbErrors);
 
 					}// Test_CutInputStr ()
 
 	/**
-	* \fn  MakeAMove (CMat& Grid, const CPosition& Pos,	const char& Direction)
+	* \fn  MakeAMove (CBoard& Grid, const CPosition& Pos,	const char& Direction, CUndoLog* Log = NULL)
 	* \brief function to move the current number according to the character in the 3rd parameter.
 	*
 	*\param Grid : Matrix 
 	*\param Pos : the number's position before the move 
 	*\param Direction : the key pressed by the player 
+	*\param Log : records the two swapped cells, if not NULL
 	*/
-	void MakeAMove (CMat& Grid,
+	void MakeAMove (CBoard& Grid,
 					const CPosition& Pos,
-					const char& Direction)	//swap two values depending on a direction
+					const char& Direction,
+					CUndoLog* Log = NULL)	//swap two values depending on a direction
 	{
+		CPhaseClock Clock (KPhaseSwap);
+		char* Other;
 		switch (Direction)
 		{
 			case 'Z':
-				swap (Grid [Pos.first][Pos.second],
-					  Grid [Pos.first - 1][Pos.second]);
+				Other = &Grid [Pos.first - 1][Pos.second];
 				break;
 			case 'S':
-				swap (Grid [Pos.first][Pos.second],
-					  Grid [Pos.first + 1][Pos.second]);
+				Other = &Grid [Pos.first + 1][Pos.second];
 				break;
 			case 'Q':
-				swap (Grid [Pos.first][Pos.second],
-					  Grid [Pos.first][Pos.second - 1]);
+				Other = &Grid [Pos.first][Pos.second - 1];
 				break;
 			case 'D':
-				swap (Grid [Pos.first][Pos.second],
-					  Grid [Pos.first][Pos.second + 1]);
+				Other = &Grid [Pos.first][Pos.second + 1];
 				break;
 			default:
 				cerr << "Direction Invalide" << endl;
+				return;
 		}
 
+		char& Cell = Grid [Pos.first][Pos.second];
+		LogCell (Log, Grid, Cell);
+		LogCell (Log, Grid, *Other);
+		swap (Cell, *Other);
+
 	}// MakeAMove ()
 
 	/**
-	* \fn bool AtLeastThreeInColumn (const CMat& Grid, CPosition& Pos, unsigned& HowMany)
+	* \fn bool AtLeastThreeInColumn (const CBoard& Grid, CPosition& Pos, unsigned& HowMany)
 	* \brief function to test if there is at least 3 consecutive numbers in the same column. 
 	*
+	* A special cell counts as its number, @see IsSameColor.
+	*
 	*\param Grid : Matrix
 	*\param Pos : the position from which we find the sequence 
 	*\param HowMany : how many consecutive numbers we have from the position Position
 	*/
-	bool AtLeastThreeInColumn (const CMat& Grid,
+	bool AtLeastThreeInColumn (const CBoard& Grid,
 							   CPosition& Pos,
 							   unsigned& HowMany)	//find a sequence of at least three same numbers in a matrix column
 	{
-		for (unsigned i = Pos.first; i < Grid.size () - 2; ++i)
-			for (unsigned j = Pos.second; j < Grid [i].size () - 1; ++j)
+		for (unsigned i = Pos.first; i < Grid.GetHeigth () - 2; ++i)
+			for (unsigned j = Pos.second; j < Grid.GetWidth () - 1; ++j)
 			{
 				if (KImpossible == Grid [i][j]) continue;
 
 				HowMany = 1;
-				for ( ; Grid [i + HowMany][j] == Grid [i][j]; )
+				for ( ; IsSameColor (Grid [i + HowMany][j], Grid [i][j]); )
 					++HowMany;
 
 				if (3 <= HowMany)
@@ -516,24 +2067,26 @@ namespace nsNumberCrush
 	}// AtLeastThreeInColumn ()
 
 	/**
-	* \fn bool AtLeastThreeInARow (const CMat& Grid, CPosition& Pos, unsigned& HowMany)
+	* \fn bool AtLeastThreeInARow (const CBoard& Grid, CPosition& Pos, unsigned& HowMany)
 	* \brief function to test if there is at least 3 consecutive numbers in the same row. 
 	*
+	* A special cell counts as its number, @see IsSameColor.
+	*
 	*\param Grid : Matrix
 	*\param Pos : the position from which we find the sequence 
 	*\param HowMany : how many consecutive numbers we have from the position Position
 	*/
-	bool AtLeastThreeInARow (const CMat& Grid,
+	bool AtLeastThreeInARow (const CBoard& Grid,
 							 CPosition & Pos,
 							 unsigned& HowMany)	//find a sequence of at least three same numbers in a matrix line
 	{
-		for (unsigned i = Pos.first; i < Grid.size () - 1; ++i)
-			for (unsigned j = Pos.second; j < Grid [i].size () - 2; ++j)
+		for (unsigned i = Pos.first; i < Grid.GetHeigth () - 1; ++i)
+			for (unsigned j = Pos.second; j < Grid.GetWidth () - 2; ++j)
 			{
 				if (KImpossible == Grid [i][j]) continue;
 
 				HowMany = 1;
-				for ( ; Grid [i][j + HowMany] == Grid [i][j]; )
+				for ( ; IsSameColor (Grid [i][j + HowMany], Grid [i][j]); )
 					++HowMany;
 
 				if (3 <= HowMany)
@@ -549,226 +2102,5147 @@ namespace nsNumberCrush
 	}// AtLeastThreeInARow ()
 
 	/**
-	* \fn RemovalInColumn (CMat& Grid, const CPosition& Pos, const unsigned& HowMany)
-	* \brief function to remove a sequence of numbers in a matrix column. 
+	* \fn SetMaskBit (CMask& Mask, const unsigned& Index)
+	* \brief function to set the bit of a cell in a bitmask.
 	*
-	*\param Grid : Matrix
-	*\param Pos : the position from which we find the sequence 
-	*\param HowMany : how many consecutive numbers we have from the position Position
+	*\param Mask : bitmask
+	*\param Index : index of the cell (row * width + column)
 	*/
-	void RemovalInColumn (CMat& Grid,
-						  const CPosition& Pos,
-						  const unsigned& HowMany)	//remove a sequence of numbers in a matrix column
+	inline void SetMaskBit (CMask& Mask, const unsigned& Index)
 	{
-		for (unsigned i (0); i < HowMany; ++i)
-			Grid [Pos.first + i][Pos.second] = KImpossible;
+		Mask [Index / KMaskBits] |= 1ULL << (Index % KMaskBits);
 
-	}// RemovalInColumn ()
+	}// SetMaskBit ()
 
 	/**
-	* \fn RemovalInRow (CMat& Grid, const CPosition& Pos, const unsigned& HowMany)
-	* \brief function to remove a sequence of numbers in a matrix line. 
+	* \fn bool : TestMaskBit (const CMask& Mask, const unsigned& Index)
+	* \brief function to test the bit of a cell in a bitmask.
 	*
-	*\param Grid : Matrix
-	*\param Pos : the position from which we find the sequence 
-	*\param HowMany : how many consecutive numbers we have from the position Position
+	*\param Mask : bitmask
+	*\param Index : index of the cell (row * width + column)
 	*/
-	void RemovalInRow (CMat& Grid,
-					   const CPosition& Pos,
-					   const unsigned& HowMany)	//remove a sequence of numbers in a matrix line
+	inline bool TestMaskBit (const CMask& Mask, const unsigned& Index)
 	{
-		for (unsigned i (0); i < HowMany; ++i)
-			Grid [Pos.first][Pos.second + i] = KImpossible;
+		return (Mask [Index / KMaskBits] >> (Index % KMaskBits)) & 1ULL;
 
-	}// RemovalInRow ()
+	}// TestMaskBit ()
 
 	/**
-	* \fn  MoveNumbersDown (CMat& Grid)
-	* \brief function to move all the matrix down. 
+	* \fn AddMaskRange (CMask& Mask, CVUInt& VCells, unsigned Index, unsigned Count)
+	* \brief function to set in a bitmask the bits of Count consecutive cells, listing the cells whose bit was not set.
 	*
-	*\param Grid : Matrix
+	* The bits are set a word at a time : the cost is the number of words, plus the number of new cells.
 	*/
-	void MoveNumbersDown (CMat& Grid)	//move all the matrix caracters down
+	inline void AddMaskRange (CMask& Mask, CVUInt& VCells, unsigned Index, unsigned Count)
 	{
-		for (unsigned i = Grid.size () - 2; i > 0; --i)
-			for (unsigned j = Grid.size () - 2; j > 0; --j)
-			{
-				if (Grid [j][i] != KImpossible) continue;
-
-				unsigned k = j - 1;
-				for ( ;0 < k && Grid [k][i] == KImpossible; )
-					--k;
+		for ( ; 0 != Count; )
+		{
+			const unsigned Shift  = Index % KMaskBits;
+			const unsigned NbBits = min (Count, KMaskBits - Shift);
+			const unsigned long long Range = (KMaskBits == NbBits ? ~0ULL : (1ULL << NbBits) - 1) << Shift;
 
-				swap (Grid [k][i], Grid [j][i]);
-			}
+			unsigned long long& Word = Mask [Index / KMaskBits];
+			for (unsigned long long New = Range & ~Word; New; New &= New - 1)
+				VCells.push_back (Index - Shift + __builtin_ctzll (New));
+			Word |= Range;
 
-	}// MoveNumbersDown ()
+			Index += NbBits;
+			Count -= NbBits;
+		}
 
+	}// AddMaskRange ()
 
 	/**
-	* \fn HandleGrid (CMat& Grid, CVPair& VPosColumn, CVPair& VPosRow, CVUInt& VHowManyCol,  CVUInt& VHowManyRow)
-	* \brief function to find then remove a sequence of numbers in a matrix line. 
+	* \fn FindRuns (const CBoard& Grid, CVRun& VRuns, CMask& Cleared)
+	* \brief function to find every maximal sequence of at least 3 numbers, in one sweep per axis.
+	*
+	* Each cell is read once per axis : a sequence is only emitted when it ends,
+	* so a sequence of 5 is reported once and never again as sub-sequences.
+	* The sequences of the columns are added in the order they end, row after row.
 	*
 	*\param Grid : Matrix
-	*\param VPosColumn : the position from which we find the sequence in column
-	*\param VPosRow : the position from which we find the sequence in row
-	*\param VHowManyCol : how many consecutive numbers we have from the position VPosColumn
-	*\param VHowManyRow : how many consecutive numbers we have from the position VPosRow
+	*\param VRuns : the sequences found, columns first then rows
+	*\param Cleared : one bit set for every cell belonging to at least one sequence
 	*/
-	void HandleGrid (CMat& Grid,
-					 CVPair& VPosColumn,
-					 CVPair& VPosRow,
-					 CVUInt& VHowManyCol,
-					 CVUInt& VHowManyRow)
+	void FindRuns (const CBoard& Grid, CVRun& VRuns, CMask& Cleared)	//find all sequences of at least three same numbers
 	{
-		unsigned HowMany;
-		CPosition Pos;
-
-		//find all sequences of at least three numbers in column
-		for ( ; AtLeastThreeInColumn (Grid, Pos, HowMany); )
-		{
-			VPosColumn.push_back (Pos);
-			VHowManyCol.push_back (HowMany);
-			++Pos.second;
-		}
+		const unsigned Heigth = Grid.GetHeigth ();
+		const unsigned Width  = Grid.GetWidth ();
+		VRuns.clear ();
+		Cleared.assign ((Heigth * Width + KMaskBits - 1) / KMaskBits, 0);
 
-		//find all sequences of at least three numbers in a row
-		Pos.first = Pos.second = 0;
-		for ( ; AtLeastThreeInARow (Grid, Pos, HowMany); )
+		//columns : walk the matrix row by row, one running length per column
+		CVUInt VLength (Width, 0);
+		for (unsigned i (1); i < Heigth; ++i)
+			for (unsigned j (1); j < Width - 1; ++j)
+			{
+				if (KImpossible != Grid [i][j] && IsSameColor (Grid [i][j], Grid [i - 1][j]))
+				{
+					++VLength [j];
+					continue;
+				}
+
+				if (3 <= VLength [j])
+				{
+					CRun Run;
+					Run.Start  = CPosition (i - VLength [j], j);
+					Run.Axis   = KAxisColumn;
+					Run.Length = VLength [j];
+					VRuns.push_back (Run);
+
+					for (unsigned k (Run.Start.first); k < i; ++k)
+						SetMaskBit (Cleared, k * Width + j);
+				}
+				VLength [j] = 1;
+			}
+
+		//rows : the sentinel column closes every sequence
+		for (unsigned i (1); i < Heigth - 1; ++i)
+		{
+			unsigned Length (1);
+			for (unsigned j (2); j < Width; ++j)
+			{
+				if (KImpossible != Grid [i][j] && IsSameColor (Grid [i][j], Grid [i][j - 1]))
+				{
+					++Length;
+					continue;
+				}
+
+				if (3 <= Length)
+				{
+					CRun Run;
+					Run.Start  = CPosition (i, j - Length);
+					Run.Axis   = KAxisRow;
+					Run.Length = Length;
+					VRuns.push_back (Run);
+
+					for (unsigned k (Run.Start.second); k < j; ++k)
+						SetMaskBit (Cleared, i * Width + k);
+				}
+				Length = 1;
+			}
+		}
+
+	}// FindRuns ()
+
+	/**
+	* \fn unsigned : Equal3Partial (const char* A, const char* B, const char* C, const unsigned& Count)
+	* \brief function to compare three sequences of cells, one cell at a time.
+	*
+	* Bit k of the result is set when A [k], B [k] and C [k] hold the same number.
+	*
+	*\param A : first sequence
+	*\param B : second sequence
+	*\param C : third sequence
+	*\param Count : how many cells to compare (KLanes at most)
+	*/
+	unsigned Equal3Partial (const char* A, const char* B, const char* C, const unsigned& Count)
+	{
+		unsigned Bits (0);
+		for (unsigned k (0); k < Count; ++k)
+			if (KImpossible != A [k] && IsSameColor (A [k], B [k]) && IsSameColor (A [k], C [k]))
+				Bits |= 1u << k;
+
+		return Bits;
+
+	}// Equal3Partial ()
+
+	/**
+	* \fn unsigned : Equal3Scalar (const char* A, const char* B, const char* C)
+	* \brief scalar kernel comparing KLanes cells, used when the processor has no SIMD unit.
+	*/
+	unsigned Equal3Scalar (const char* A, const char* B, const char* C)
+	{
+		return Equal3Partial (A, B, C, KLanes);
+
+	}// Equal3Scalar ()
+
+#ifdef NUMBERCRUSH_X86
+	/**
+	* \fn unsigned : Equal3Sse2 (const char* A, const char* B, const char* C)
+	* \brief SSE2 kernel comparing KLanes cells, 16 at a time.
+	*/
+	__attribute__ ((target ("sse2")))
+	unsigned Equal3Sse2 (const char* A, const char* B, const char* C)
+	{
+		const __m128i Colors = _mm_set1_epi8 (KColorBits);
+		const __m128i Empty  = _mm_setzero_si128 ();	//the number of KImpossible
+
+		unsigned Bits (0);
+		for (unsigned k (0); k < KLanes; k += 16)
+		{
+			const __m128i VA = _mm_and_si128 (Colors, _mm_loadu_si128 (reinterpret_cast <const __m128i*> (A + k)));
+			const __m128i VB = _mm_and_si128 (Colors, _mm_loadu_si128 (reinterpret_cast <const __m128i*> (B + k)));
+			const __m128i VC = _mm_and_si128 (Colors, _mm_loadu_si128 (reinterpret_cast <const __m128i*> (C + k)));
+
+			__m128i Equal = _mm_and_si128 (_mm_cmpeq_epi8 (VA, VB), _mm_cmpeq_epi8 (VA, VC));
+			Equal = _mm_andnot_si128 (_mm_cmpeq_epi8 (VA, Empty), Equal);
+			Bits |= unsigned (_mm_movemask_epi8 (Equal)) << k;
+		}
+
+		return Bits;
+
+	}// Equal3Sse2 ()
+
+	/**
+	* \fn unsigned : Equal3Avx2 (const char* A, const char* B, const char* C)
+	* \brief AVX2 kernel comparing KLanes cells at once.
+	*/
+	__attribute__ ((target ("avx2")))
+	unsigned Equal3Avx2 (const char* A, const char* B, const char* C)
+	{
+		const __m256i Colors = _mm256_set1_epi8 (KColorBits);
+		const __m256i Empty  = _mm256_setzero_si256 ();	//the number of KImpossible
+
+		const __m256i VA = _mm256_and_si256 (Colors, _mm256_loadu_si256 (reinterpret_cast <const __m256i*> (A)));
+		const __m256i VB = _mm256_and_si256 (Colors, _mm256_loadu_si256 (reinterpret_cast <const __m256i*> (B)));
+		const __m256i VC = _mm256_and_si256 (Colors, _mm256_loadu_si256 (reinterpret_cast <const __m256i*> (C)));
+
+		__m256i Equal = _mm256_and_si256 (_mm256_cmpeq_epi8 (VA, VB), _mm256_cmpeq_epi8 (VA, VC));
+		Equal = _mm256_andnot_si256 (_mm256_cmpeq_epi8 (VA, Empty), Equal);
+
+		return unsigned (_mm256_movemask_epi8 (Equal));
+
+	}// Equal3Avx2 ()
+#endif
+
+	/**
+	* \fn CEqual3Kernel : SelectEqual3Kernel ()
+	* \brief function to choose the fastest kernel supported by the processor running the game.
+	*/
+	CEqual3Kernel SelectEqual3Kernel ()
+	{
+#ifdef NUMBERCRUSH_X86
+		__builtin_cpu_init ();
+		if (__builtin_cpu_supports ("avx2"))
+			return Equal3Avx2;
+		if (__builtin_cpu_supports ("sse2"))
+			return Equal3Sse2;
+#endif
+		return Equal3Scalar;
+
+	}// SelectEqual3Kernel ()
+
+	/**
+	* \fn CEqual3Kernel : Equal3Kernel ()
+	* \brief function to get the kernel chosen at the first call.
+	*/
+	CEqual3Kernel Equal3Kernel ()
+	{
+		static const CEqual3Kernel Kernel = SelectEqual3Kernel ();
+		return Kernel;
+
+	}// Equal3Kernel ()
+
+	/**
+	* \fn OrMaskBits (CMask& Mask, const unsigned& Index, const unsigned long long& Bits)
+	* \brief function to set in a bitmask the bits of several consecutive cells.
+	*
+	*\param Mask : bitmask
+	*\param Index : index of the cell matching the bit 0 of Bits
+	*\param Bits : bits of the cells, KLanes at most
+	*/
+	inline void OrMaskBits (CMask& Mask, const unsigned& Index, const unsigned long long& Bits)
+	{
+		if (!Bits) return;
+
+		const unsigned Word  = Index / KMaskBits;
+		const unsigned Shift = Index % KMaskBits;
+		Mask [Word] |= Bits << Shift;
+		if (Shift && (Bits >> (KMaskBits - Shift)))
+			Mask [Word + 1] |= Bits >> (KMaskBits - Shift);
+
+	}// OrMaskBits ()
+
+	/**
+	* \fn AddMaskBits (CMask& Mask, CVUInt& VCells, const unsigned& Index, const unsigned long long& Bits)
+	* \brief function to set in a bitmask the bits of several consecutive cells, listing the cells whose bit was not set.
+	*
+	*\param Mask : bitmask
+	*\param VCells : receives the cells added
+	*\param Index : index of the cell matching the bit 0 of Bits
+	*\param Bits : bits of the cells, KLanes at most
+	*/
+	inline void AddMaskBits (CMask& Mask, CVUInt& VCells, const unsigned& Index, const unsigned long long& Bits)
+	{
+		const unsigned Shift = Index % KMaskBits;
+		const unsigned long long VWords [2] = { Bits << Shift, Shift ? Bits >> (KMaskBits - Shift) : 0 };
+		for (unsigned w (0); w < 2; ++w)
+		{
+			if (!VWords [w]) continue;
+
+			unsigned long long& Word = Mask [Index / KMaskBits + w];
+			for (unsigned long long New = VWords [w] & ~Word; New; New &= New - 1)
+				VCells.push_back ((Index / KMaskBits + w) * KMaskBits + __builtin_ctzll (New));
+			Word |= VWords [w];
+		}
+
+	}// AddMaskBits ()
+
+	/**
+	* \fn AddColorCells (CMask& Mask, CVUInt& VCells, const char* Cells, const unsigned& First, const unsigned& Count, const char& Cell, CEqual3Kernel Kernel = Equal3Kernel ())
+	* \brief function to set in a bitmask the bits of the cells holding the number of Cell, KLanes cells at a time.
+	*
+	* The cells are compared by the kernel with a row of KLanes copies of Cell : the empty cells
+	* and the border never match.
+	*
+	*\param Mask : bitmask
+	*\param VCells : receives the cells added
+	*\param Cells : the cells of the matrix
+	*\param First : index of the first cell compared
+	*\param Count : how many consecutive cells to compare
+	*\param Cell : a cell of the number searched
+	*\param Kernel : the comparison kernel
+	*/
+	void AddColorCells (CMask& Mask, CVUInt& VCells, const char* Cells, const unsigned& First, const unsigned& Count,
+						const char& Cell, CEqual3Kernel Kernel = Equal3Kernel ())
+	{
+		char VSame [KLanes];
+		fill (VSame, VSame + KLanes, Cell);
+
+		for (unsigned k (0); k < Count; k += KLanes)
+		{
+			const unsigned long long Bits = (k + KLanes <= Count)
+										  ? Kernel (Cells + First + k, VSame, VSame)
+										  : Equal3Partial (Cells + First + k, VSame, VSame, Count - k);
+			AddMaskBits (Mask, VCells, First + k, Bits);
+		}
+
+	}// AddColorCells ()
+
+	/**
+	* \fn FindMatchMask (const CBoard& Grid, CMask& Cleared, CEqual3Kernel Kernel = Equal3Kernel ())
+	* \brief function to find the cells belonging to a sequence of at least 3 numbers, KLanes cells at a time.
+	*
+	* A row is compared with itself shifted by 1 and by 2 cells, then with the two rows below it.
+	* Gives the same bitmask as FindRuns, without the list of sequences.
+	*
+	*\param Grid : Matrix
+	*\param Cleared : one bit set for every cell belonging to at least one sequence
+	*\param Kernel : the comparison kernel
+	*/
+	void FindMatchMask (const CBoard& Grid, CMask& Cleared, CEqual3Kernel Kernel = Equal3Kernel ())
+	{
+		const unsigned Heigth = Grid.GetHeigth ();
+		const unsigned Width  = Grid.GetWidth ();
+
+		Cleared.assign ((Heigth * Width + KMaskBits - 1) / KMaskBits, 0);
+		if (Heigth < 3 || Width < 3) return;
+
+		//rows : the windows start between the column 1 and the column Width - 4
+		const unsigned NbWindows = (Width > 4) ? Width - 4 : 0;
+		for (unsigned i (1); i < Heigth - 1; ++i)
+		{
+			const char* Row = Grid [i] + 1;
+			for (unsigned k (0); k < NbWindows; k += KLanes)
+			{
+				const unsigned long long Bits = (k + KLanes <= NbWindows)
+											  ? Kernel (Row + k, Row + k + 1, Row + k + 2)
+											  : Equal3Partial (Row + k, Row + k + 1, Row + k + 2, NbWindows - k);
+				const unsigned Index = i * Width + 1 + k;
+				OrMaskBits (Cleared, Index,     Bits);
+				OrMaskBits (Cleared, Index + 1, Bits);
+				OrMaskBits (Cleared, Index + 2, Bits);
+			}
+		}
+
+		//columns : every row is compared with the two rows below it
+		const unsigned NbCells = Width - 2;
+		for (unsigned i (1); i + 2 < Heigth - 1; ++i)
+		{
+			const char* Row = Grid [i] + 1;
+			for (unsigned k (0); k < NbCells; k += KLanes)
+			{
+				const unsigned long long Bits = (k + KLanes <= NbCells)
+											  ? Kernel (Row + k, Row + k + Width, Row + k + 2 * Width)
+											  : Equal3Partial (Row + k, Row + k + Width, Row + k + 2 * Width, NbCells - k);
+				const unsigned Index = i * Width + 1 + k;
+				OrMaskBits (Cleared, Index,             Bits);
+				OrMaskBits (Cleared, Index + Width,     Bits);
+				OrMaskBits (Cleared, Index + 2 * Width, Bits);
+			}
+		}
+
+	}// FindMatchMask ()
+
+	/**
+	* \fn bool : IsMaskEmpty (const CMask& Mask)
+	* \brief function to test if no bit is set in a bitmask.
+	*/
+	bool IsMaskEmpty (const CMask& Mask)
+	{
+		for (unsigned w (0); w < Mask.size (); ++w)
+			if (Mask [w]) return false;
+
+		return true;
+
+	}// IsMaskEmpty ()
+
+	/**
+	* \fn FindMaskRuns (const CBoard& Grid, const CMask& Cleared, CVRun& VRuns)
+	* \brief function to list the sequences of the cells of a bitmask built by FindMatchMask, in the order of FindRuns.
+	*
+	* Only the cells of the bitmask are read : a sequence starts on a cell whose number differs from
+	* the one of the cell above it, or on its left. The sequences of the columns are sorted by the
+	* row where they end, as FindRuns adds them.
+	*
+	*\param Grid : Matrix
+	*\param Cleared : the cells belonging to a sequence
+	*\param VRuns : the sequences found, columns first then rows
+	*/
+	void FindMaskRuns (const CBoard& Grid, const CMask& Cleared, CVRun& VRuns)
+	{
+		const unsigned Width = Grid.GetWidth ();
+		const char* Cells = Grid.GetData ();
+
+		VRuns.clear ();
+		for (unsigned Axis (0); Axis < 2; ++Axis)
+		{
+			const unsigned Step = Axis ? 1 : Width;
+			const unsigned First = VRuns.size ();
+			for (unsigned w (0); w < Cleared.size (); ++w)
+				for (unsigned long long Bits = Cleared [w]; Bits; Bits &= Bits - 1)
+				{
+					const unsigned Index = w * KMaskBits + __builtin_ctzll (Bits);
+					if (IsSameColor (Cells [Index - Step], Cells [Index])) continue;
+
+					unsigned Length (1);
+					for ( ; IsSameColor (Cells [Index + Length * Step], Cells [Index]); )
+						++Length;
+					if (Length < 3) continue;
+
+					CRun Run;
+					Run.Start  = CPosition (Index / Width, Index % Width);
+					Run.Axis   = Axis ? KAxisRow : KAxisColumn;
+					Run.Length = Length;
+					VRuns.push_back (Run);
+				}
+
+			if (0 == Axis)
+				sort (VRuns.begin () + First, VRuns.end (), [] (const CRun& A, const CRun& B)
+				{
+					return A.Start.first + A.Length != B.Start.first + B.Length ? A.Start.first + A.Length < B.Start.first + B.Length
+																				: A.Start.second < B.Start.second;
+				});
+		}
+
+	}// FindMaskRuns ()
+
+					/**
+					* \fn LegacyMatchMask (const CBoard& Grid, CMask& Expected)
+					* \brief test function building the bitmask of FindRuns with AtLeastThreeInARow and AtLeastThreeInColumn, restarted on each row.
+					*/
+					void LegacyMatchMask (const CBoard& Grid, CMask& Expected)
+					{
+						Expected.assign ((Grid.GetHeigth () * Grid.GetWidth () + KMaskBits - 1) / KMaskBits, 0);
+						for (unsigned i (1); i < Grid.GetHeigth () - 1; ++i)
+						{
+							unsigned HowMany;
+							CPosition Pos (i, 1);
+							for ( ; AtLeastThreeInARow (Grid, Pos, HowMany) && Pos.first == i; Pos.second += HowMany)
+								for (unsigned k (0); k < HowMany; ++k)
+									SetMaskBit (Expected, i * Grid.GetWidth () + Pos.second + k);
+
+							Pos = CPosition (i, 1);
+							for ( ; AtLeastThreeInColumn (Grid, Pos, HowMany) && Pos.first == i; ++Pos.second)
+								for (unsigned k (0); k < HowMany; ++k)
+									SetMaskBit (Expected, (i + k) * Grid.GetWidth () + Pos.second);
+						}
+
+					}// LegacyMatchMask ()
+
+					/**
+					* \fn bool : Test_FindMatchMask ()
+					* \brief test function @see FindMatchMask and FindMaskRuns, cross-checked with AtLeastThreeInARow, AtLeastThreeInColumn and FindRuns.
+					*/
+					bool Test_FindMatchMask ()
+					{
+						CVLine VCandies;
+						VCandies.push_back ('1');
+						VCandies.push_back ('2');
+						VCandies.push_back ('3');
+
+						CEqual3Kernel VKernels [] = { Equal3Scalar,
+#ifdef NUMBERCRUSH_X86
+													  Equal3Sse2,
+													  __builtin_cpu_supports ("avx2") ? Equal3Avx2 : Equal3Sse2,
+#endif
+													};
+						unsigned NbErrors (0);
+						for (unsigned Test (0); Test < 500; ++Test)
+						{
+							CBoard Grid;
+							InitGrid (Grid, 3 + rand () % 70, 3 + rand () % 40);
+							CRandom Random (Test);
+							FillGrid (Grid, VCandies, Random);
+							for (unsigned k (0); k < Grid.GetHeigth () * Grid.GetWidth () / 8; ++k)	//a few special cells
+							{
+								char& Cell = Grid [1 + Random.Next (Grid.GetHeigth () - 2)][1 + Random.Next (Grid.GetWidth () - 2)];
+								Cell = MakeSpecial (Cell, 1 + Random.Next (KSpecialColor));
+							}
+
+							CMask Expected;
+							LegacyMatchMask (Grid, Expected);
+
+							CVRun VRuns;
+							CMask Cleared;
+							FindRuns (Grid, VRuns, Cleared);
+							if (Cleared != Expected) ++NbErrors;
+
+							for (unsigned k (0); k < sizeof (VKernels) / sizeof (VKernels [0]); ++k)
+							{
+								FindMatchMask (Grid, Cleared, VKernels [k]);
+								if (Cleared != Expected) ++NbErrors;
+							}
+
+							//the same sequences from the cells of the bitmask, @see FindMaskRuns
+							CVRun VMaskRuns;
+							FindMaskRuns (Grid, Cleared, VMaskRuns);
+							if (VMaskRuns.size () != VRuns.size ()) ++NbErrors;
+							for (unsigned r (0); r < min (VRuns.size (), VMaskRuns.size ()); ++r)
+								if (VMaskRuns [r].Start != VRuns [r].Start || VMaskRuns [r].Axis != VRuns [r].Axis || VMaskRuns [r].Length != VRuns [r].Length)
+									++NbErrors;
+						}
+						return ReportTest ("Test_FindMatchMask", NbErrors);
+
+					}// Test_FindMatchMask ()
+
+	/**
+	* \fn RemovalInColumn (CBoard& Grid, const CPosition& Pos, const unsigned& HowMany, CUndoLog* Log = NULL)
+	* \brief function to remove a sequence of numbers in a matrix column. 
+	*
+	*\param Grid : Matrix
+	*\param Pos : the position from which we find the sequence 
+	*\param HowMany : how many consecutive numbers we have from the position Position
+	*\param Log : records the removed cells, if not NULL
+	*/
+	void RemovalInColumn (CBoard& Grid,
+						  const CPosition& Pos,
+						  const unsigned& HowMany,
+						  CUndoLog* Log = NULL)	//remove a sequence of numbers in a matrix column
+	{
+		for (unsigned i (0); i < HowMany; ++i)
+		{
+			LogCell (Log, Grid, Grid [Pos.first + i][Pos.second]);
+			Grid [Pos.first + i][Pos.second] = KImpossible;
+		}
+
+	}// RemovalInColumn ()
+
+	/**
+	* \fn RemovalInRow (CBoard& Grid, const CPosition& Pos, const unsigned& HowMany, CUndoLog* Log = NULL)
+	* \brief function to remove a sequence of numbers in a matrix line. 
+	*
+	*\param Grid : Matrix
+	*\param Pos : the position from which we find the sequence 
+	*\param HowMany : how many consecutive numbers we have from the position Position
+	*\param Log : records the removed cells, if not NULL
+	*/
+	void RemovalInRow (CBoard& Grid,
+					   const CPosition& Pos,
+					   const unsigned& HowMany,
+					   CUndoLog* Log = NULL)	//remove a sequence of numbers in a matrix line
+	{
+		for (unsigned i (0); i < HowMany; ++i)
+		{
+			LogCell (Log, Grid, Grid [Pos.first][Pos.second + i]);
+			Grid [Pos.first][Pos.second + i] = KImpossible;
+		}
+
+	}// RemovalInRow ()
+
+	/**
+	* \fn RemoveMasked (CBoard& Grid, const CMask& Cleared, CUndoLog* Log = NULL)
+	* \brief function to remove every cell whose bit is set in a bitmask.
+	*
+	*\param Grid : Matrix
+	*\param Cleared : bitmask of the cells to remove
+	*\param Log : records the removed cells, if not NULL
+	*/
+	void RemoveMasked (CBoard& Grid, const CMask& Cleared, CUndoLog* Log = NULL)	//remove the cells of a bitmask
+	{
+		char* Cells = Grid.GetData ();
+
+		for (unsigned w (0); w < Cleared.size (); ++w)
+			for (unsigned long long Bits = Cleared [w]; Bits; Bits &= Bits - 1)
+			{
+				char& Cell = Cells [w * KMaskBits + __builtin_ctzll (Bits)];
+				LogCell (Log, Grid, Cell);
+				Cell = KImpossible;
+			}
+
+	}// RemoveMasked ()
+
+	/**
+	* \fn unsigned : CompactColumn (CBoard& Grid, const unsigned& Col, CUndoLog* Log = NULL)
+	* \brief function to move the numbers of a column down, in one pass.
+	*
+	* A write cursor goes up from the bottom and receives the numbers in the order they are read.
+	*
+	*\param Grid : Matrix
+	*\param Col : the column
+	*\param Log : records the moved cells, if not NULL
+	*\return how many empty cells are left at the top of the column
+	*/
+	unsigned CompactColumn (CBoard& Grid, const unsigned& Col, CUndoLog* Log = NULL)	//move the caracters of a column down
+	{
+		CBoard::CColumn Column = Grid.Column (Col);
+
+		unsigned Write = Grid.GetHeigth () - 2;
+		for (unsigned Read = Grid.GetHeigth () - 2; Read > 0; --Read)
+		{
+			if (Column [Read] == KImpossible) continue;
+
+			if (Write != Read)
+			{
+				LogCell (Log, Grid, Column [Write]);
+				LogCell (Log, Grid, Column [Read]);
+				Column [Write] = Column [Read];
+				Column [Read]  = KImpossible;
+			}
+			--Write;
+		}
+
+		return Write;
+
+	}// CompactColumn ()
+
+	/**
+	* \fn  MoveNumbersDown (CBoard& Grid, CVUInt& VNbEmpty, CUndoLog* Log = NULL)
+	* \brief function to move all the matrix down. 
+	*
+	*\param Grid : Matrix
+	*\param VNbEmpty : how many empty cells are left at the top of each column
+	*\param Log : records the moved cells, if not NULL
+	*/
+	void MoveNumbersDown (CBoard& Grid, CVUInt& VNbEmpty, CUndoLog* Log = NULL)	//move all the matrix caracters down
+	{
+		CPhaseClock Clock (KPhaseFall);
+		VNbEmpty.assign (Grid.GetWidth (), 0);
+
+		for (unsigned j (1); j < Grid.GetWidth () - 1; ++j)
+			VNbEmpty [j] = CompactColumn (Grid, j, Log);
+
+	}// MoveNumbersDown ()
+
+
+	/**
+	* \fn SplitRuns (const CVRun& VRuns, CVPair& VPosColumn, CVPair& VPosRow, CVUInt& VHowManyCol,  CVUInt& VHowManyRow)
+	* \brief function to add the sequences found to the lists of HandleGrid, one for the columns and one for the rows.
+	*/
+	void SplitRuns (const CVRun& VRuns,
+					CVPair& VPosColumn,
+					CVPair& VPosRow,
+					CVUInt& VHowManyCol,
+					CVUInt& VHowManyRow)
+	{
+		for (unsigned i (0); i < VRuns.size (); ++i)
+		{
+			if (KAxisColumn == VRuns [i].Axis)
+			{
+				VPosColumn.push_back (VRuns [i].Start);
+				VHowManyCol.push_back (VRuns [i].Length);
+			}
+			else
+			{
+				VPosRow.push_back (VRuns [i].Start);
+				VHowManyRow.push_back (VRuns [i].Length);
+			}
+		}
+
+	}// SplitRuns ()
+
+	/**
+	* \fn HandleGrid (CBoard& Grid, CVPair& VPosColumn, CVPair& VPosRow, CVUInt& VHowManyCol,  CVUInt& VHowManyRow)
+	* \brief function to find then remove a sequence of numbers in a matrix line. 
+	*
+	*\param Grid : Matrix
+	*\param VPosColumn : the position from which we find the sequence in column
+	*\param VPosRow : the position from which we find the sequence in row
+	*\param VHowManyCol : how many consecutive numbers we have from the position VPosColumn
+	*\param VHowManyRow : how many consecutive numbers we have from the position VPosRow
+	*/
+	void HandleGrid (CBoard& Grid,
+					 CVPair& VPosColumn,
+					 CVPair& VPosRow,
+					 CVUInt& VHowManyCol,
+					 CVUInt& VHowManyRow)
+	{
+		CPhaseClock Clock (KPhaseDetection);
+		CVRun VRuns;
+		CMask Cleared;
+
+		//the cells of the sequences with the SIMD kernel : most calls find nothing
+		FindMatchMask (Grid, Cleared);
+		if (IsMaskEmpty (Cleared)) return;
+
+		//then the sequences of at least three numbers, in column and in row, from the cells found only
+		FindMaskRuns (Grid, Cleared, VRuns);
+		SplitRuns (VRuns, VPosColumn, VPosRow, VHowManyCol, VHowManyRow);
+
+		//remove sequences
+		Clock.Switch (KPhaseRemoval);
+		RemoveMasked (Grid, Cleared);
+
+	}// HandleGrid ()
+
+	/**
+	* \fn InitDirtyRegion (CDirtyRegion& Dirty, const CBoard& Grid)
+	* \brief function to create an empty dirty region matching a matrix.
+	*/
+	void InitDirtyRegion (CDirtyRegion& Dirty, const CBoard& Grid)
+	{
+		Dirty.VColumns.clear ();
+		Dirty.VColumns.reserve (Grid.GetWidth ());
+		Dirty.VTop.assign (Grid.GetWidth (), 0);
+		Dirty.VBottom.assign (Grid.GetWidth (), 0);
+
+	}// InitDirtyRegion ()
+
+	/**
+	* \fn MarkDirty (CDirtyRegion& Dirty, const unsigned& Top, const unsigned& Bottom, const unsigned& Col)
+	* \brief function to add the rows Top to Bottom of a column to a dirty region.
+	*/
+	void MarkDirty (CDirtyRegion& Dirty, const unsigned& Top, const unsigned& Bottom, const unsigned& Col)
+	{
+		if (0 == Dirty.VTop [Col])
+		{
+			Dirty.VColumns.push_back (Col);
+			Dirty.VTop [Col]	= Top;
+			Dirty.VBottom [Col]	= Bottom;
+			return;
+		}
+		Dirty.VTop [Col]	= min (Dirty.VTop [Col], Top);
+		Dirty.VBottom [Col]	= max (Dirty.VBottom [Col], Bottom);
+
+	}// MarkDirty ()
+
+	/**
+	* \fn ClearDirtyRegion (CDirtyRegion& Dirty)
+	* \brief function to empty a dirty region, in a time proportional to its number of columns.
+	*/
+	void ClearDirtyRegion (CDirtyRegion& Dirty)
+	{
+		for (unsigned j (0); j < Dirty.VColumns.size (); ++j)
+			Dirty.VTop [Dirty.VColumns [j]] = Dirty.VBottom [Dirty.VColumns [j]] = 0;
+		Dirty.VColumns.clear ();
+
+	}// ClearDirtyRegion ()
+
+	/**
+	* \fn InitTurnScratch (CTurnScratch& Scratch, const CBoard& Grid)
+	* \brief function to size the buffers of the moves for a matrix, for its largest cascade.
+	*
+	* A cell belongs to one sequence per axis at most and a sequence holds 3 cells at least.
+	*/
+	void InitTurnScratch (CTurnScratch& Scratch, const CBoard& Grid)
+	{
+		const unsigned NbCells	= Grid.GetHeigth () * Grid.GetWidth ();
+		const unsigned NbMasked	= (NbCells + KMaskBits - 1) / KMaskBits;
+		const unsigned NbReserved = min (NbCells, KScratchCells);	//a move of a large board only changes a few cells
+
+		Scratch.VRuns.clear ();
+		Scratch.VRuns.reserve (2 * NbReserved / 3 + 1);
+		Scratch.VFrom.assign (Grid.GetHeigth (), 0);
+		Scratch.VTo.assign (Grid.GetHeigth (), 0);
+		Scratch.VCells.clear ();
+		Scratch.VCells.reserve (NbReserved);
+		Scratch.Cleared.reserve (min (NbMasked, KScratchCells));
+		Scratch.Removed.assign (NbMasked, 0);
+		Scratch.Crossed.assign (NbMasked, 0);
+		Scratch.VRemoved.clear ();
+		Scratch.VRemoved.reserve (NbReserved);
+		Scratch.VCrossings.clear ();
+		Scratch.VCrossings.reserve (NbReserved);
+		Scratch.VSpecials.clear ();
+		Scratch.VSpecials.reserve (2 * NbReserved / 3 + 1);
+
+	}// InitTurnScratch ()
+
+	/**
+	* \fn bool : GetNeighbour (const CPosition& Pos, const char& Direction, CPosition& Neighbour)
+	* \brief function to get the cell swapped with Pos by MakeAMove.
+	*
+	*\param Pos : position of the moved number
+	*\param Direction : 'Z', 'S', 'Q' or 'D'
+	*\param Neighbour : position of the other cell
+	*\return false if Direction is not a direction
+	*/
+	bool GetNeighbour (const CPosition& Pos, const char& Direction, CPosition& Neighbour)
+	{
+		Neighbour = Pos;
+		switch (Direction)
+		{
+			case 'Z':
+				--Neighbour.first;
+				return true;
+			case 'S':
+				++Neighbour.first;
+				return true;
+			case 'Q':
+				--Neighbour.second;
+				return true;
+			case 'D':
+				++Neighbour.second;
+				return true;
+		}
+
+		return false;
+
+	}// GetNeighbour ()
+
+	/**
+	* \fn MarkMoveDirty (CDirtyRegion& Dirty, const CPosition& Pos, const char& Direction)
+	* \brief function to add the two cells swapped by MakeAMove to a dirty region.
+	*/
+	void MarkMoveDirty (CDirtyRegion& Dirty, const CPosition& Pos, const char& Direction)
+	{
+		CPosition Neighbour;
+		if (!GetNeighbour (Pos, Direction, Neighbour)) return;
+
+		MarkDirty (Dirty, Pos.first, Pos.first, Pos.second);
+		MarkDirty (Dirty, Neighbour.first, Neighbour.first, Neighbour.second);
+
+	}// MarkMoveDirty ()
+
+	/**
+	* \fn FindRunsInLine (const char* First, const unsigned& Stride, const unsigned& From, const unsigned& To, CVRun& VRuns, const CPosition& Origin, const char& Axis)
+	* \brief function to find the maximal sequences of a row or a column that contain a cell between From and To.
+	*
+	* The sequences are followed beyond From and To until they end, the sentinel border stopping them.
+	*
+	*\param First : cell 0 of the row or the column
+	*\param Stride : distance between two cells of the line
+	*\param From : first cell to check
+	*\param To : last cell to check
+	*\param VRuns : the sequences found are added to it
+	*\param Origin : position of the cell 0
+	*\param Axis : KAxisRow or KAxisColumn
+	*/
+	void FindRunsInLine (const char* First, const unsigned& Stride,
+						 const unsigned& From, const unsigned& To,
+						 CVRun& VRuns, const CPosition& Origin, const char& Axis)
+	{
+		unsigned Begin = From;
+		for ( ; KImpossible != First [Begin * Stride] && IsSameColor (First [(Begin - 1) * Stride], First [Begin * Stride]); )
+			--Begin;
+
+		unsigned Length (1);
+		for (unsigned k (Begin + 1); ; ++k)
+		{
+			if (KImpossible != First [k * Stride] && IsSameColor (First [k * Stride], First [(k - 1) * Stride]))
+			{
+				++Length;
+				continue;
+			}
+
+			if (3 <= Length)
+			{
+				CRun Run;
+				Run.Start  = (KAxisRow == Axis) ? CPosition (Origin.first, k - Length)
+												: CPosition (k - Length, Origin.second);
+				Run.Axis   = Axis;
+				Run.Length = Length;
+				VRuns.push_back (Run);
+			}
+			Length = 1;
+
+			if (k > To) break;
+		}
+
+	}// FindRunsInLine ()
+
+	/**
+	* \fn FindRunsInRegion <TShape> (const CBoard& Grid, const CDirtyRegion& Dirty, CTurnScratch& Scratch)
+	* \brief function to find the maximal sequences holding at least one cell of a dirty region.
+	*
+	* The cells outside the region must not hold any sequence : only the dirty columns,
+	* and the dirty part of each row, are checked.
+	*
+	*\param Grid : Matrix
+	*\param Dirty : the cells changed since the last search
+	*\param Scratch : receives the sequences found in VRuns, columns first then rows; VFrom and VTo are left at 0
+	*/
+	template <typename TShape = CAnyShape>
+	void FindRunsInRegion (const CBoard& Grid, const CDirtyRegion& Dirty, CTurnScratch& Scratch)
+	{
+		CVRun& VRuns = Scratch.VRuns;
+		VRuns.clear ();
+
+		//columns
+		for (unsigned j (0); j < Dirty.VColumns.size (); ++j)
+		{
+			const unsigned Col = Dirty.VColumns [j];
+			FindRunsInLine (Grid.GetData () + Col, TShape::GetWidth (Grid),
+							Dirty.VTop [Col], Dirty.VBottom [Col],
+							VRuns, CPosition (0, Col), KAxisColumn);
+		}
+
+		//rows : dirty columns of each dirty row
+		CVUInt& VFrom = Scratch.VFrom;
+		CVUInt& VTo   = Scratch.VTo;
+		unsigned MinRow (TShape::GetHeigth (Grid)), MaxRow (0);
+		for (unsigned j (0); j < Dirty.VColumns.size (); ++j)
+		{
+			const unsigned Col = Dirty.VColumns [j];
+			for (unsigned i (Dirty.VTop [Col]); i <= Dirty.VBottom [Col]; ++i)
+			{
+				VFrom [i] = (0 == VFrom [i]) ? Col : min (VFrom [i], Col);
+				VTo [i]   = max (VTo [i], Col);
+			}
+			MinRow = min (MinRow, Dirty.VTop [Col]);
+			MaxRow = max (MaxRow, Dirty.VBottom [Col]);
+		}
+		for (unsigned i (MinRow); i <= MaxRow; ++i)
+		{
+			if (0 == VFrom [i]) continue;
+
+			FindRunsInLine (Grid.GetData () + i * TShape::GetWidth (Grid), 1, VFrom [i], VTo [i],
+							VRuns, CPosition (i, 0), KAxisRow);
+			VFrom [i] = VTo [i] = 0;
+		}
+
+	}// FindRunsInRegion ()
+
+	/**
+	* \fn ClearRuns <TShape> (CBoard& Grid, CDirtyRegion& Dirty, CTurnScratch& Scratch, unsigned& TurnScore, unsigned& Multiplier, const bool& IsSpecials, const CPosition* VMoved, CUndoLog* Log = NULL)
+	* \brief function to remove the sequences of Scratch.VRuns, and the cells cleared by the special cells they hold.
+	*
+	* Each cell is added once to the bitmask Scratch.Removed and listed in Scratch.VRemoved, the
+	* sequences first. A special cell of the list fires when its turn comes, adding its row, its
+	* column, the 3x3 square around it or every cell of its number : a chain of special cells
+	* costs the number of cells it clears. The cells of a number are found by AddColorCells, a
+	* word of the bitmask at a time, and once per step for each number.
+	*
+	* With IsSpecials, a sequence of 5 leaves a KSpecialColor, two crossing sequences a KSpecialBomb
+	* and a sequence of 4 a line. It goes on the moved cell if the sequence holds it, on the crossing
+	* or in the middle of the sequence otherwise.
+	*
+	*\param Grid : Matrix
+	*\param Dirty : the columns above the removed cells are added to it
+	*\param Scratch : holds the sequences in VRuns, buffers sized by InitTurnScratch
+	*\param TurnScore : increased by KSquareValue for each number of the sequences, and each number cleared by a special cell
+	*\param Multiplier : increased by one for each sequence and each special cell fired
+	*\param IsSpecials : the sequences make special cells and the special cells fire, otherwise they are removed as numbers
+	*\param VMoved : the two swapped cells on the first step of a move, NULL otherwise
+	*\param Log : records every changed cell, if not NULL
+	*/
+	template <typename TShape = CAnyShape>
+	void ClearRuns (CBoard& Grid, CDirtyRegion& Dirty, CTurnScratch& Scratch, unsigned& TurnScore, unsigned& Multiplier,
+					const bool& IsSpecials, const CPosition* VMoved, CUndoLog* Log = NULL)
+	{
+		const unsigned Heigth = TShape::GetHeigth (Grid);
+		const unsigned Width  = TShape::GetWidth (Grid);
+		const CVRun& VRuns = Scratch.VRuns;
+		CVUInt& VRemoved = Scratch.VRemoved;
+		char* Cells = Grid.GetData ();
+
+		//the cells of the sequences : a cell already listed is the crossing of two sequences
+		VRemoved.clear ();
+		for (unsigned r (0); r < VRuns.size (); ++r)
+		{
+			const CRun& Run = VRuns [r];
+			const unsigned Step = (KAxisColumn == Run.Axis) ? Width : 1;
+			TurnScore += Run.Length * KSquareValue;
+
+			for (unsigned k (0), Index = Run.Start.first * Width + Run.Start.second; k < Run.Length; ++k, Index += Step)
+			{
+				if (!TestMaskBit (Scratch.Removed, Index))
+				{
+					SetMaskBit (Scratch.Removed, Index);
+					VRemoved.push_back (Index);
+				}
+				else if (IsSpecials)
+				{
+					SetMaskBit (Scratch.Crossed, Index);
+					Scratch.VCrossings.push_back (Index);
+				}
+			}
+		}
+		Multiplier += VRuns.size ();
+		const unsigned NbRunCells = VRemoved.size ();
+
+		//the special cells made by the sequences, the strongest one when two go on the same cell
+		CVCellChange& VSpecials = Scratch.VSpecials;
+		VSpecials.clear ();
+		for (unsigned r (0); IsSpecials && r < VRuns.size (); ++r)
+		{
+			const CRun& Run = VRuns [r];
+			const unsigned Step  = (KAxisColumn == Run.Axis) ? Width : 1;
+			const unsigned First = Run.Start.first * Width + Run.Start.second;
+
+			unsigned Crossing (0);	//the row 0 is the border : 0 is no crossing
+			for (unsigned k (0); k < Run.Length && !Crossing; ++k)
+				if (TestMaskBit (Scratch.Crossed, First + k * Step)) Crossing = First + k * Step;
+
+			const unsigned Kind = (5 <= Run.Length) ? KSpecialColor
+								: Crossing			? KSpecialBomb
+								: (4 == Run.Length)	? (KAxisRow == Run.Axis ? KSpecialColumn : KSpecialRow)
+								: 0;
+			if (0 == Kind) continue;
+
+			CCellChange Special;
+			Special.Offset = Crossing ? Crossing : First + (Run.Length - 1) / 2 * Step;
+			Special.Value  = MakeSpecial (Cells [First], Kind);
+			for (unsigned m (0); VMoved && m < 2; ++m)
+			{
+				const unsigned Along = (KAxisRow == Run.Axis) ? VMoved [m].second - Run.Start.second : VMoved [m].first - Run.Start.first;
+				const bool IsOnAxis	 = (KAxisRow == Run.Axis) ? VMoved [m].first == Run.Start.first : VMoved [m].second == Run.Start.second;
+				if (IsOnAxis && Along < Run.Length)
+					Special.Offset = VMoved [m].first * Width + VMoved [m].second;
+			}
+
+			unsigned s (0);
+			for ( ; s < VSpecials.size () && VSpecials [s].Offset != Special.Offset; ++s) ;
+			if (s == VSpecials.size ())
+				VSpecials.push_back (Special);
+			else if (CellKind (VSpecials [s].Value) < Kind)
+				VSpecials [s].Value = Special.Value;
+		}
+		for (unsigned c (0); c < Scratch.VCrossings.size (); ++c)
+			Scratch.Crossed [Scratch.VCrossings [c] / KMaskBits] = 0;
+		Scratch.VCrossings.clear ();
+
+		//fire the special cells of the list, the cells they clear being listed after the others
+		unsigned FiredColors (0);	//one bit for each number already cleared by a KSpecialColor
+		for (unsigned k (0); IsSpecials && k < VRemoved.size (); ++k)
+		{
+			const unsigned Index = VRemoved [k];
+			const unsigned Row = Index / Width, Col = Index % Width;
+			switch (CellKind (Cells [Index]))
+			{
+				case KSpecialRow:
+					AddMaskRange (Scratch.Removed, VRemoved, Row * Width + 1, Width - 2);
+					break;
+				case KSpecialColumn:
+					for (unsigned i (1); i < Heigth - 1; ++i)
+						AddMaskRange (Scratch.Removed, VRemoved, i * Width + Col, 1);
+					break;
+				case KSpecialBomb:
+				{
+					const unsigned Left = max (Col, 2u) - 1, Right = min (Col + 1, Width - 2);
+					for (unsigned i (max (Row, 2u) - 1); i <= min (Row + 1, Heigth - 2); ++i)
+						AddMaskRange (Scratch.Removed, VRemoved, i * Width + Left, Right - Left + 1);
+					break;
+				}
+				case KSpecialColor:
+					if (!(FiredColors >> CellColor (Cells [Index]) & 1))
+						AddColorCells (Scratch.Removed, VRemoved, Cells, Width + 1, (Heigth - 2) * Width - 2, Cells [Index]);
+					FiredColors |= 1u << CellColor (Cells [Index]);
+					break;
+				default:
+					continue;
+			}
+			++Multiplier;
+		}
+		TurnScore += (VRemoved.size () - NbRunCells) * KSquareValue;
+
+		//remove the cells, the columns above them become dirty, then put the special cells made
+		for (unsigned k (0); k < VRemoved.size (); ++k)
+		{
+			const unsigned Index = VRemoved [k];
+			LogCell (Log, Grid, Cells [Index]);
+			Cells [Index] = KImpossible;
+			Scratch.Removed [Index / KMaskBits] &= ~(1ULL << (Index % KMaskBits));
+			MarkDirty (Dirty, 1, Index / Width, Index % Width);
+		}
+		for (unsigned s (0); s < VSpecials.size (); ++s)
+		{
+			LogCell (Log, Grid, Cells [VSpecials [s].Offset]);
+			Cells [VSpecials [s].Offset] = VSpecials [s].Value;
+		}
+
+	}// ClearRuns ()
+
+	/**
+	* \fn ResolveCascade <TShape> (CBoard& Grid, const CVLine& Vect, CRandom& Random, CDirtyRegion& Dirty, CTurnScratch& Scratch, unsigned& TurnScore, unsigned& Multiplier, const CPosition* VMoved, CUndoLog* Log = NULL, CVUInt* VSteps = NULL)
+	* \brief function to remove the sequences, move the numbers down and refill the matrix until nothing moves.
+	*
+	* Only the dirty region is searched : after a move, the two swapped cells, then the columns
+	* above the removed cells. The cost depends on the size of the cascade, not of the matrix.
+	* After KMaxSpecialSteps steps, the special cells are removed as numbers and no longer made.
+	*
+	*\param Grid : Matrix
+	*\param Vect : the numbers used to refill the matrix
+	*\param Random : random generator
+	*\param Dirty : the cells changed by the move, empty on return
+	*\param Scratch : buffers sized by InitTurnScratch
+	*\param TurnScore : score of the turn, @see ClearRuns
+	*\param Multiplier : increased by one for each sequence and each special cell fired
+	*\param VMoved : the two swapped cells, where the special cells made by the move go ; NULL to play without special cells
+	*\param Log : records every changed cell, if not NULL
+	*\param VSteps : receives the checkpoint of Log after each removal, fall and refill, if not NULL
+	*/
+	template <typename TShape = CAnyShape>
+	void ResolveCascade (CBoard& Grid, const CVLine& Vect, CRandom& Random, CDirtyRegion& Dirty, CTurnScratch& Scratch,
+						 unsigned& TurnScore, unsigned& Multiplier, const CPosition* VMoved, CUndoLog* Log = NULL, CVUInt* VSteps = NULL)
+	{
+		const CVRun& VRuns = Scratch.VRuns;
+		const CPosition* VSwapped = VMoved;
+		CPhaseClock Clock;
+		for (unsigned Step (0); !Dirty.VColumns.empty (); ++Step)
+		{
+			Clock.Switch (KPhaseDetection);
+			FindRunsInRegion <TShape> (Grid, Dirty, Scratch);
+			ClearDirtyRegion (Dirty);
+			if (!VRuns.empty ()) CountCascadeStep ();
+
+			//remove sequences, the columns above them become dirty
+			Clock.Switch (KPhaseRemoval);
+			ClearRuns <TShape> (Grid, Dirty, Scratch, TurnScore, Multiplier, NULL != VMoved && Step < KMaxSpecialSteps, VSwapped, Log);
+			VSwapped = NULL;
+			MarkStep (Log, VSteps);
+
+			//move down the dirty columns only
+			Clock.Switch (KPhaseFall);
+			for (unsigned j (0); j < Dirty.VColumns.size (); ++j)
+				CompactColumn (Grid, Dirty.VColumns [j], Log);
+			MarkStep (Log, VSteps);
+
+			//then refill their empty cells, at the top
+			Clock.Switch (KPhaseFill);
+			for (unsigned j (0); j < Dirty.VColumns.size (); ++j)
+			{
+				CBoard::CColumn Column = Grid.Column (Dirty.VColumns [j]);
+				for (unsigned i (1); i < TShape::GetHeigth (Grid) - 1 && KImpossible == Column [i]; ++i)
+				{
+					LogCell (Log, Grid, Column [i]);
+					Column [i] = Vect [Random.Next (TShape::GetNbCandies (Vect))];
+				}
+			}
+			MarkStep (Log, VSteps);
+		}
+
+	}// ResolveCascade ()
+
+					/**
+					* \fn bool : Test_ClearRuns ()
+					* \brief test function @see ClearRuns : the special cells made by the sequences of 4, 5 and in L, and fired when cleared.
+					*/
+					bool Test_ClearRuns ()
+					{
+						struct CCase
+						{
+							const char*	VRows [5];	//the matrix before the move
+							CPosition	Pos;		//the move
+							char		Direction;
+							CPosition	Special;	//the special cell expected after the first removal, (0, 0) for none
+							char		Value;
+							unsigned	NbRemoved;	//the empty cells after the first removal
+						};
+						const CCase VCases [] =
+						{
+							{ { "23452", "34123", "11214", "45345", "52432" }, CPosition (3, 3), 'Z', CPosition (3, 3), 'Q', 3 },	//4 in row
+							{ { "23452", "34123", "11211", "45345", "52432" }, CPosition (3, 3), 'Z', CPosition (3, 3), 'q', 4 },	//5 in row
+							{ { "23452", "34123", "1Q214", "45345", "52432" }, CPosition (3, 3), 'Z', CPosition (3, 3), 'Q', 7 },	//with a special cell of the same number
+							{ { "23452", "34123", "45134", "11215", "52142" }, CPosition (4, 3), 'S', CPosition (4, 3), 'a', 5 },	//L
+							{ { "23452", "34523", "115Q4", "45345", "52432" }, CPosition (3, 3), 'D', CPosition (0, 0), 0, 7 },		//column cleared
+							{ { "23452", "34523", "115a4", "45345", "52432" }, CPosition (3, 3), 'D', CPosition (0, 0), 0, 10 },		//3x3 cleared
+							{ { "21452", "34513", "115q4", "41345", "52412" }, CPosition (3, 3), 'D', CPosition (0, 0), 0, 7 }		//number cleared
+						};
+
+						CVLine VCandies;
+						VCandies.push_back ('6');
+						VCandies.push_back ('7');
+						VCandies.push_back ('8');
+
+						unsigned NbErrors (0);
+						for (unsigned c (0); c < sizeof (VCases) / sizeof (VCases [0]); ++c)
+						{
+							const CCase& Case = VCases [c];
+							CBoard Grid;
+							InitGrid (Grid, 7, 7);
+							for (unsigned i (1); i <= 5; ++i)
+								copy (Case.VRows [i - 1], Case.VRows [i - 1] + 5, Grid [i] + 1);
+
+							CDirtyRegion Dirty;
+							InitDirtyRegion (Dirty, Grid);
+							CTurnScratch Scratch;
+							InitTurnScratch (Scratch, Grid);
+							CRandom Random (c);
+							CUndoLog Log;
+							CVUInt VSteps;
+
+							CPosition VMoved [2] = { Case.Pos };
+							GetNeighbour (Case.Pos, Case.Direction, VMoved [1]);
+							MakeAMove (Grid, Case.Pos, Case.Direction);
+							MarkMoveDirty (Dirty, Case.Pos, Case.Direction);
+
+							//the legacy functions see the special cells as their number, like FindRuns
+							CVRun VRuns;
+							CMask Cleared, Expected;
+							FindRuns (Grid, VRuns, Cleared);
+							LegacyMatchMask (Grid, Expected);
+							if (Cleared != Expected || IsMaskEmpty (Cleared)) ++NbErrors;
+
+							unsigned TurnScore (0), Multiplier (0);
+							ResolveCascade (Grid, VCandies, Random, Dirty, Scratch, TurnScore, Multiplier, VMoved, &Log, &VSteps);
+
+							//back to the first removal
+							Log.Rollback (Grid, VSteps [0]);
+							unsigned NbRemoved (0);
+							for (unsigned i (1); i <= 5; ++i)
+								NbRemoved += count (Grid [i] + 1, Grid [i] + 6, KImpossible);
+							if (NbRemoved != Case.NbRemoved) ++NbErrors;
+							if (0 != Case.Special.first && Grid [Case.Special.first][Case.Special.second] != Case.Value) ++NbErrors;
+							if (IsMaskEmpty (Scratch.Removed) == false || IsMaskEmpty (Scratch.Crossed) == false) ++NbErrors;
+						}
+						return ReportTest ("Test_ClearRuns", NbErrors);
+
+					}// Test_ClearRuns ()
+
+	/**
+	* \fn FindBitRuns (const CBitBoard& Bits, const unsigned& Shift, unsigned long long* Run, unsigned& NbCells, unsigned& NbRuns)
+	* \brief function to find the cells of a CBitBoard belonging to a sequence of at least 3, on one axis.
+	*
+	* Same = OR of b & b >> Shift over the planes : the cells equal to the next one. A cell
+	* starts 3 equal numbers when Same & Same >> Shift, spread back to the 3 cells.
+	*
+	*\param Shift : 1 for the sequences in column, the stride for the sequences in row
+	*\param Run : the cells of the sequences
+	*\param NbCells : increased by the number of cells of the sequences
+	*\param NbRuns : increased by the number of sequences
+	*/
+	void FindBitRuns (const CBitBoard& Bits, const unsigned& Shift, unsigned long long* Run, unsigned& NbCells, unsigned& NbRuns)
+	{
+		const unsigned NbWords = Bits.GetNbWords ();
+		unsigned long long Same [KBitWords] = {}, Next [KBitWords], Last [KBitWords];
+
+		for (unsigned k (0); k < Bits.GetNbCandies (); ++k)
+		{
+			const unsigned long long* Plane = Bits.GetPlane (k);
+			ShiftPlaneDown (Plane, Shift, NbWords, Next);
+			for (unsigned w (0); w < NbWords; ++w)
+				Same [w] |= Plane [w] & Next [w];
+		}
+
+		ShiftPlaneDown (Same, Shift, NbWords, Next);
+		unsigned long long Any (0);
+		for (unsigned w (0); w < NbWords; ++w)
+			Any |= Run [w] = Same [w] & Next [w];
+		if (!Any) return;
+
+		ShiftPlaneUp (Run, Shift, NbWords, Next);
+		ShiftPlaneUp (Next, Shift, NbWords, Last);
+		for (unsigned w (0); w < NbWords; ++w)
+			Run [w] |= Next [w] | Last [w];
+
+		//a sequence is counted at its first cell : the one not equal to the cell before it
+		ShiftPlaneUp (Same, Shift, NbWords, Next);
+		for (unsigned w (0); w < NbWords; ++w)
+		{
+			NbCells += __builtin_popcountll (Run [w]);
+			NbRuns  += __builtin_popcountll (Run [w] & ~Next [w]);
+		}
+
+	}// FindBitRuns ()
+
+	/**
+	* \fn MakeBitSpecials (const CBitBoard& Bits, const unsigned long long* InColumn, const unsigned long long* InRow, const unsigned* VMoved, unsigned* VSpecials, unsigned* VKinds, unsigned& NbSpecials)
+	* \brief function to find the special cells made by the sequences of a CBitBoard, like ClearRuns.
+	*
+	* The sequences of each number are walked from their first cell, the top one of a column or the
+	* left one of a row. A special cell goes on a moved cell of the sequence, on its first crossing
+	* or in its middle.
+	*
+	*\param InColumn : the cells of the sequences in column, @see FindBitRuns
+	*\param InRow : the cells of the sequences in row
+	*\param VMoved : the bits of the two swapped cells on the first step of a move, NULL otherwise
+	*\param VSpecials : receives the bits of the special cells, once each
+	*\param VKinds : receives their kind, the strongest one when two sequences make one on the same cell
+	*\param NbSpecials : receives the number of special cells
+	*/
+	void MakeBitSpecials (const CBitBoard& Bits, const unsigned long long* InColumn, const unsigned long long* InRow,
+						  const unsigned* VMoved, unsigned* VSpecials, unsigned* VKinds, unsigned& NbSpecials)
+	{
+		const unsigned NbWords = Bits.GetNbWords ();
+		const unsigned Stride  = Bits.GetStride ();
+
+		unsigned long long Crossed [KBitWords], Run [KBitWords];
+		for (unsigned w (0); w < NbWords; ++w)
+			Crossed [w] = InColumn [w] & InRow [w];
+
+		NbSpecials = 0;
+		for (unsigned Axis (0); Axis < 2; ++Axis)
+			for (unsigned k (0); k < Bits.GetNbCandies (); ++k)
+			{
+				for (unsigned w (0); w < NbWords; ++w)
+					Run [w] = (Axis ? InRow [w] : InColumn [w]) & Bits.GetPlane (k) [w];
+
+				//a column is walked down to the bit 0, a row to the next column
+				const int Step = Axis ? int (Stride) : -1;
+				for (unsigned w (0); w < NbWords; ++w)
+					for (unsigned long long Cells = Run [w]; Cells; Cells &= Cells - 1)
+					{
+						const unsigned First = w * KMaskBits + __builtin_ctzll (Cells);
+						if (Axis ? First >= Stride && GetPlaneBits (Run, First - Stride, 1) : GetPlaneBits (Run, First + 1, 1))
+							continue;
+
+						unsigned Length (0), Crossing (0);
+						bool IsCrossed (false);
+						for (int Bit = First; Bit >= 0 && Bit < int (NbWords * KMaskBits) && GetPlaneBits (Run, Bit, 1); Bit += Step, ++Length)
+							if (!IsCrossed && GetPlaneBits (Crossed, Bit, 1))
+							{
+								IsCrossed = true;
+								Crossing  = Bit;
+							}
+
+						const unsigned Kind = (5 <= Length) ? KSpecialColor
+											: IsCrossed		? KSpecialBomb
+											: (4 == Length)	? (Axis ? KSpecialColumn : KSpecialRow)
+											: 0;
+						if (0 == Kind) continue;
+
+						unsigned Special = IsCrossed ? Crossing : First + Step * int ((Length - 1) / 2);
+						for (unsigned m (0); VMoved && m < 2; ++m)
+						{
+							const bool IsOnAxis = Axis ? VMoved [m] % Stride == First % Stride && VMoved [m] >= First
+													   : VMoved [m] / Stride == First / Stride && VMoved [m] <= First;
+							const unsigned Along = Axis ? (VMoved [m] - First) / Stride : First - VMoved [m];
+							if (IsOnAxis && Along < Length)
+								Special = VMoved [m];
+						}
+
+						unsigned s (0);
+						for ( ; s < NbSpecials && VSpecials [s] != Special; ++s) ;
+						if (s == NbSpecials)
+						{
+							VSpecials [NbSpecials]	= Special;
+							VKinds [NbSpecials++]	= Kind;
+						}
+						else
+							VKinds [s] = max (VKinds [s], Kind);
+					}
+			}
+
+	}// MakeBitSpecials ()
+
+	/**
+	* \fn QueueBitSpecials (const CBitBoard& Bits, const unsigned long long* Cells, const unsigned long long* Specials, unsigned* VQueue, unsigned& NbQueued)
+	* \brief function to add to a queue the special cells among some cells of a CBitBoard, row after row from the left.
+	*/
+	void QueueBitSpecials (const CBitBoard& Bits, const unsigned long long* Cells, const unsigned long long* Specials,
+						   unsigned* VQueue, unsigned& NbQueued)
+	{
+		//the lower bits of a column are the lower rows
+		const unsigned Stride = Bits.GetStride ();
+		auto Order = [Stride] (const unsigned& Bit) { return (Stride - Bit % Stride) * KMaxBitColumns + Bit / Stride; };
+
+		const unsigned First = NbQueued;
+		for (unsigned w (0); w < Bits.GetNbWords (); ++w)
+			for (unsigned long long Found = Cells [w] & Specials [w]; Found; Found &= Found - 1)
+			{
+				const unsigned Bit = w * KMaskBits + __builtin_ctzll (Found);
+				unsigned i = NbQueued++;
+				for ( ; i > First && Order (VQueue [i - 1]) > Order (Bit); --i)
+					VQueue [i] = VQueue [i - 1];
+				VQueue [i] = Bit;
+			}
+
+	}// QueueBitSpecials ()
+
+	/**
+	* \fn AddBitCells (const CBitBoard& Bits, const unsigned long long* Cells, const unsigned long long* Specials, unsigned long long* Removed, unsigned* VColumns, unsigned& NbColumns, unsigned long long& Listed, unsigned* VQueue, unsigned& NbQueued)
+	* \brief function to add the cells cleared by a special cell to the removed cells of a CBitBoard, in the order of ClearRuns.
+	*
+	* ClearRuns adds the cells of a special cell row after row, from the left : the columns not
+	* listed yet are added in the order of their top new cell, the special cells among the new
+	* cells are queued in that order too.
+	*
+	*\param Cells : the cells cleared
+	*\param Specials : the special cells of the matrix
+	*\param Removed : the cells removed by the step, receives the new ones
+	*\param VColumns : the columns from 0, in the order they are dirty
+	*\param NbColumns : the number of columns of VColumns
+	*\param Listed : one bit for each column of VColumns
+	*\param VQueue : the special cells to fire
+	*\param NbQueued : the number of special cells of VQueue
+	*/
+	void AddBitCells (const CBitBoard& Bits, const unsigned long long* Cells, const unsigned long long* Specials,
+					  unsigned long long* Removed, unsigned* VColumns, unsigned& NbColumns, unsigned long long& Listed,
+					  unsigned* VQueue, unsigned& NbQueued)
+	{
+		const unsigned Heigth = Bits.GetHeigth ();
+		const unsigned Stride = Bits.GetStride ();
+
+		unsigned long long New [KBitWords];
+		for (unsigned w (0); w < Bits.GetNbWords (); ++w)
+		{
+			New [w] = Cells [w] & ~Removed [w];
+			Removed [w] |= New [w];
+		}
+
+		unsigned VTop [KMaxBitColumns];
+		const unsigned First = NbColumns;
+		for (unsigned c (0); c < Bits.GetWidth (); ++c)
+		{
+			const unsigned long long Column = GetPlaneBits (New, c * Stride, Heigth);
+			if (!Column || ((Listed >> c) & 1ULL)) continue;
+
+			Listed |= 1ULL << c;
+			VTop [c] = KMaskBits - 1 - __builtin_clzll (Column);
+			unsigned i = NbColumns++;
+			for ( ; i > First && VTop [VColumns [i - 1]] < VTop [c]; --i)
+				VColumns [i] = VColumns [i - 1];
+			VColumns [i] = c;
+		}
+
+		QueueBitSpecials (Bits, New, Specials, VQueue, NbQueued);
+
+	}// AddBitCells ()
+
+	/**
+	* \fn FireBitSpecials (const CBitBoard& Bits, const unsigned long long* InColumn, const unsigned long long* InRow, unsigned* VColumns, const unsigned& NbInColumn, unsigned& NbColumns, unsigned long long& Listed, unsigned long long* Removed, unsigned& TurnScore, unsigned& Multiplier)
+	* \brief function to fire the special cells of the sequences of a CBitBoard, then the ones they clear, like ClearRuns.
+	*
+	* The special cells are fired in the order ClearRuns lists them : the ones of the sequences in
+	* column first, column after column in the order of VColumns and from the top, then the ones of
+	* the sequences in row, row after row. The columns they clear are added to VColumns in the
+	* order ClearRuns marks them dirty.
+	*
+	*\param InColumn : the cells of the sequences in column, @see FindBitRuns
+	*\param InRow : the cells of the sequences in row
+	*\param VColumns : the columns from 0 in the order they are dirty, the NbInColumn first ones holding a sequence in column
+	*\param NbColumns : the number of columns of VColumns
+	*\param Listed : one bit for each column of VColumns
+	*\param Removed : the cells of the sequences, receives the cells cleared
+	*\param TurnScore : increased by KSquareValue for each cell cleared
+	*\param Multiplier : increased by one for each special cell fired
+	*/
+	void FireBitSpecials (const CBitBoard& Bits, const unsigned long long* InColumn, const unsigned long long* InRow,
+						  unsigned* VColumns, const unsigned& NbInColumn, unsigned& NbColumns, unsigned long long& Listed,
+						  unsigned long long* Removed, unsigned& TurnScore, unsigned& Multiplier)
+	{
+		const unsigned Heigth	= Bits.GetHeigth ();
+		const unsigned Width	= Bits.GetWidth ();
+		const unsigned Stride	= Bits.GetStride ();
+		const unsigned NbWords	= Bits.GetNbWords ();
+
+		unsigned long long Specials [KBitWords], InRowOnly [KBitWords];
+		unsigned NbRunCells (0);
+		for (unsigned w (0); w < NbWords; ++w)
+		{
+			Specials [w] = 0;
+			for (unsigned Kind (0); Kind < KSpecialColor; ++Kind)
+				Specials [w] |= Bits.GetKinds (Kind) [w];
+			InRowOnly [w] = InRow [w] & ~InColumn [w];
+			NbRunCells += __builtin_popcountll (Removed [w]);
+		}
+
+		//the special cells of the sequences
+		unsigned VQueue [KBitWords * KMaskBits];
+		unsigned NbQueued (0);
+		for (unsigned i (0); i < NbInColumn; ++i)
+		{
+			const unsigned Offset = VColumns [i] * Stride;
+			for (unsigned long long Cells = GetPlaneBits (InColumn, Offset, Heigth) & GetPlaneBits (Specials, Offset, Heigth); Cells; )
+			{
+				const unsigned Top = KMaskBits - 1 - __builtin_clzll (Cells);
+				VQueue [NbQueued++] = Offset + Top;
+				Cells &= ~(1ULL << Top);
+			}
+		}
+		QueueBitSpecials (Bits, InRowOnly, Specials, VQueue, NbQueued);
+
+		//then fire them, the special cells they clear being queued after the others
+		for (unsigned q (0); q < NbQueued; ++q)
+		{
+			const unsigned Bit = VQueue [q];
+			const unsigned Col = Bit / Stride, Row = Heigth - Bit % Stride;
+
+			unsigned Kind (0);
+			for ( ; !GetPlaneBits (Bits.GetKinds (Kind), Bit, 1); ++Kind) ;
+
+			unsigned long long Cells [KBitWords] = {};
+			switch (Kind + 1)
+			{
+				case KSpecialRow:
+					for (unsigned c (0); c < Width; ++c)
+						SetPlaneBits (Cells, c * Stride + Bit % Stride, 1, 1ULL);
+					break;
+				case KSpecialColumn:
+					SetPlaneBits (Cells, Col * Stride, Heigth, (1ULL << Heigth) - 1);
+					break;
+				case KSpecialBomb:
+					for (unsigned i (max (Row, 2u) - 1); i <= min (Row + 1, Heigth); ++i)
+						for (unsigned c (max (Col, 1u) - 1); c <= min (Col + 1, Width - 1); ++c)
+							SetPlaneBits (Cells, Bits.Index (i, c + 1), 1, 1ULL);
+					break;
+				case KSpecialColor:
+					for (unsigned k (0); k < Bits.GetNbCandies (); ++k)
+						if (GetPlaneBits (Bits.GetPlane (k), Bit, 1))
+							copy (Bits.GetPlane (k), Bits.GetPlane (k) + NbWords, Cells);
+					break;
+			}
+			AddBitCells (Bits, Cells, Specials, Removed, VColumns, NbColumns, Listed, VQueue, NbQueued);
+			++Multiplier;
+		}
+
+		unsigned NbCells (0);
+		for (unsigned w (0); w < NbWords; ++w)
+			NbCells += __builtin_popcountll (Removed [w]);
+		TurnScore += (NbCells - NbRunCells) * KSquareValue;
+
+	}// FireBitSpecials ()
+
+	/**
+	* \fn ResolveBitCascade (CBitBoard& Bits, CRandom& Random, const CPosition& Pos, const CPosition& Neighbour, unsigned& TurnScore, unsigned& Multiplier, const bool& IsSpecials, CBoard& Grid, CUndoLog* Log = NULL)
+	* \brief function to resolve the cascade of a move on a CBitBoard like ResolveCascade, then copy the changed cells to the matrix.
+	*
+	* Each step finds the sequences of the whole matrix with FindBitRuns, then moves the
+	* numbers of each column down with CompactBits. The columns are refilled in the order
+	* ResolveCascade marks them dirty, so both draw the same numbers from Random.
+	*
+	* With IsSpecials, the special cells of the sequences are fired by FireBitSpecials and the
+	* ones the sequences make are put by MakeBitSpecials before the numbers move down. After
+	* KMaxSpecialSteps steps, the special cells are removed as numbers, as in ResolveCascade.
+	*
+	*\param Bits : the matrix as bitboards, the two cells of the move already swapped
+	*\param Random : random generator
+	*\param Pos : position of the moved number
+	*\param Neighbour : the other cell of the move
+	*\param TurnScore : increased by KSquareValue for each number of each sequence, and each number cleared by a special cell
+	*\param Multiplier : increased by one for each sequence and each special cell fired
+	*\param IsSpecials : the sequences make special cells
+	*\param Grid : Matrix, receives the changed cells
+	*\param Log : records the cells changed in Grid, if not NULL
+	*/
+	void ResolveBitCascade (CBitBoard& Bits, CRandom& Random, const CPosition& Pos, const CPosition& Neighbour,
+							unsigned& TurnScore, unsigned& Multiplier, const bool& IsSpecials, CBoard& Grid, CUndoLog* Log = NULL)
+	{
+		const unsigned Heigth	= Bits.GetHeigth ();
+		const unsigned Stride	= Bits.GetStride ();
+		const unsigned NbWords	= Bits.GetNbWords ();
+		const unsigned VMoved [2] = { Bits.Index (Pos.first, Pos.second), Bits.Index (Neighbour.first, Neighbour.second) };
+		const unsigned* VSwapped = IsSpecials ? VMoved : NULL;
+
+		//columns from 0, in the order they are dirty : first the two columns of the move
+		unsigned VOrder [KMaxBitColumns], VNext [KMaxBitColumns], VTop [KMaxBitColumns], VBottom [KMaxBitColumns];
+		unsigned NbOrder (0);
+		VOrder [NbOrder++] = Pos.second - 1;
+		if (Neighbour.second != Pos.second)
+			VOrder [NbOrder++] = Neighbour.second - 1;
+		unsigned long long Touched (0);
+
+		CPhaseClock Clock;
+		for (unsigned Step (0); ; ++Step)
+		{
+			Clock.Switch (KPhaseDetection);
+			unsigned long long InColumn [KBitWords], InRow [KBitWords];
+			unsigned NbCells (0), NbRuns (0);
+			FindBitRuns (Bits, 1, InColumn, NbCells, NbRuns);
+			FindBitRuns (Bits, Stride, InRow, NbCells, NbRuns);
+			if (0 == NbRuns) break;
+			CountCascadeStep ();
+
+			TurnScore  += NbCells * KSquareValue;
+			Multiplier += NbRuns;
+
+			//the columns holding a sequence in column, in the previous order, @see FindRunsInRegion
+			unsigned NbNext (0);
+			unsigned long long Listed (0);
+			for (unsigned i (0); i < NbOrder; ++i)
+				if (GetPlaneBits (InColumn, VOrder [i] * Stride, Heigth))
+				{
+					Listed |= 1ULL << VOrder [i];
+					VNext [NbNext++] = VOrder [i];
+				}
+
+			//a matrix holding sequences before the move also has them outside the dirty columns
+			for (unsigned c (0); c < Bits.GetWidth (); ++c)
+				if (!((Listed >> c) & 1ULL) && GetPlaneBits (InColumn, c * Stride, Heigth))
+				{
+					Listed |= 1ULL << c;
+					VNext [NbNext++] = c;
+				}
+
+			//then the other columns holding a sequence in row, from the top row, then from the left
+			const unsigned NbInColumn = NbNext;
+			for (unsigned c (0); c < Bits.GetWidth (); ++c)
+			{
+				const unsigned long long Cells = GetPlaneBits (InRow, c * Stride, Heigth);
+				if (!Cells || ((Listed >> c) & 1ULL)) continue;
+
+				Listed |= 1ULL << c;
+				VTop [c] = KMaskBits - 1 - __builtin_clzll (Cells);
+				unsigned i = NbNext++;
+				for ( ; i > NbInColumn && VTop [VNext [i - 1]] < VTop [c]; --i)
+					VNext [i] = VNext [i - 1];
+				VNext [i] = c;
+			}
+
+			//the cells cleared by the special cells, then the special cells made, which do not fall
+			unsigned long long Removed [KBitWords], Fall [KBitWords];
+			for (unsigned w (0); w < NbWords; ++w)
+				Removed [w] = InColumn [w] | InRow [w];
+			if (IsSpecials && Step < KMaxSpecialSteps)
+			{
+				Clock.Switch (KPhaseRemoval);
+				FireBitSpecials (Bits, InColumn, InRow, VNext, NbInColumn, NbNext, Listed, Removed, TurnScore, Multiplier);
+
+				unsigned VSpecials [KBitWords * KMaskBits], VKinds [KBitWords * KMaskBits], NbSpecials;
+				MakeBitSpecials (Bits, InColumn, InRow, VSwapped, VSpecials, VKinds, NbSpecials);
+				copy (Removed, Removed + NbWords, Fall);
+				for (unsigned s (0); s < NbSpecials; ++s)
+				{
+					for (unsigned Kind (0); Kind < KSpecialColor; ++Kind)
+						SetPlaneBits (Bits.GetKinds (Kind), VSpecials [s], 1, Kind + 1 == VKinds [s]);
+					SetPlaneBits (Fall, VSpecials [s], 1, 0ULL);
+				}
+			}
+			else
+				copy (Removed, Removed + NbWords, Fall);
+			VSwapped = NULL;
+
+			//remove the sequences, move the numbers down and refill each column, from the top : one pass, counted as the fall
+			Clock.Switch (KPhaseFall);
+			for (unsigned i (0); i < NbNext; ++i)
+			{
+				const unsigned Col = VNext [i], Offset = Col * Stride;
+				const unsigned long long Cleared = GetPlaneBits (Removed, Offset, Heigth), Fallen = GetPlaneBits (Fall, Offset, Heigth);
+				for (unsigned k (0); k < Bits.GetNbCandies () + (IsSpecials ? KSpecialColor : 0); ++k)
+				{
+					unsigned long long* Plane = (k < Bits.GetNbCandies ()) ? Bits.GetPlane (k) : Bits.GetKinds (k - Bits.GetNbCandies ());
+					SetPlaneBits (Plane, Offset, Heigth, CompactBits (GetPlaneBits (Plane, Offset, Heigth), Fallen));
+				}
+				for (unsigned Bit = Heigth; Bit-- > Heigth - __builtin_popcountll (Fallen); )
+				{
+					unsigned long long* Plane = Bits.GetPlane (Random.Next (Bits.GetNbCandies ()));
+					Plane [(Offset + Bit) / KMaskBits] |= 1ULL << ((Offset + Bit) % KMaskBits);
+				}
+
+				const unsigned Bottom = Heigth - __builtin_ctzll (Cleared);
+				VBottom [Col] = ((Touched >> Col) & 1ULL) ? max (VBottom [Col], Bottom) : Bottom;
+				Touched |= 1ULL << Col;
+			}
+
+			copy (VNext, VNext + NbNext, VOrder);
+			NbOrder = NbNext;
+		}
+
+		//copy to the matrix the top of the columns that changed
+		Clock.Switch (KNbPhases);
+		for (unsigned long long Columns = Touched; Columns; Columns &= Columns - 1)
+		{
+			const unsigned Col = __builtin_ctzll (Columns);
+
+			char VColumn [KMaskBits];
+			for (unsigned k (0); k < Bits.GetNbCandies (); ++k)
+				for (unsigned long long Cells = GetPlaneBits (Bits.GetPlane (k), Col * Stride, Heigth); Cells; Cells &= Cells - 1)
+					VColumn [__builtin_ctzll (Cells)] = char ('1' + k);
+			for (unsigned Kind (0); IsSpecials && Kind < KSpecialColor; ++Kind)
+				for (unsigned long long Cells = GetPlaneBits (Bits.GetKinds (Kind), Col * Stride, Heigth); Cells; Cells &= Cells - 1)
+					VColumn [__builtin_ctzll (Cells)] = MakeSpecial (VColumn [__builtin_ctzll (Cells)], Kind + 1);
+
+			for (unsigned i (1); i <= VBottom [Col]; ++i)
+			{
+				char& Cell = Grid [i][Col + 1];
+				if (Cell == VColumn [Heigth - i]) continue;
+
+				LogCell (Log, Grid, Cell);
+				Cell = VColumn [Heigth - i];
+			}
+		}
+
+	}// ResolveBitCascade ()
+
+	/** \struct CTaskQueue
+	 *
+	 * \brief the tasks of a worker : it takes them from the front, the other workers steal them from the back
+	 *
+	 */
+	struct CTaskQueue
+	{
+		mutex				Lock;	/*!< \brief protects Tasks */
+		deque <unsigned>	Tasks;	/*!< \brief index of the tasks left */
+	};
+
+	/**
+	* \fn bool : PopTask (CTaskQueue& Queue, unsigned& Task, const bool& FromFront)
+	* \brief function to take a task out of a queue.
+	*/
+	bool PopTask (CTaskQueue& Queue, unsigned& Task, const bool& FromFront)
+	{
+		lock_guard <mutex> Guard (Queue.Lock);
+		if (Queue.Tasks.empty ()) return false;
+
+		if (FromFront)
+		{
+			Task = Queue.Tasks.front ();
+			Queue.Tasks.pop_front ();
+		}
+		else
+		{
+			Task = Queue.Tasks.back ();
+			Queue.Tasks.pop_back ();
+		}
+
+		return true;
+
+	}// PopTask ()
+
+	/**
+	* \fn ParallelFor (const unsigned& NbTasks, unsigned NbThreads, const function <void (unsigned)>& Task)
+	* \brief function to run the tasks 0 to NbTasks - 1 on a work-stealing pool of threads.
+	*
+	* Each worker starts with a block of consecutive tasks; when its queue is empty,
+	* it steals from the back of the other queues. The order of execution is not fixed :
+	* a task must only write its own results.
+	*
+	*\param NbTasks : how many tasks to run
+	*\param NbThreads : how many threads, 0 for one per core
+	*\param Task : the task, called with its index
+	*/
+	void ParallelFor (const unsigned& NbTasks, unsigned NbThreads, const function <void (unsigned)>& Task)
+	{
+		if (0 == NbThreads)
+			NbThreads = max (1u, thread::hardware_concurrency ());
+		NbThreads = max (1u, min (NbThreads, NbTasks));
+
+		vector <CTaskQueue> VQueues (NbThreads);
+		for (unsigned i (0); i < NbTasks; ++i)
+			VQueues [unsigned ((unsigned long long) i * NbThreads / NbTasks)].Tasks.push_back (i);
+
+		auto Worker = [&] (const unsigned Self)
+		{
+			for (unsigned TaskIndex; ; )
+			{
+				bool Found = PopTask (VQueues [Self], TaskIndex, true);
+				for (unsigned k (1); !Found && k < NbThreads; ++k)
+					Found = PopTask (VQueues [(Self + k) % NbThreads], TaskIndex, false);
+				if (!Found) break;
+
+				Task (TaskIndex);
+			}
+		};
+
+		vector <thread> VThreads;
+		for (unsigned w (1); w < NbThreads; ++w)
+			VThreads.push_back (thread (Worker, w));
+		Worker (0);
+		for (unsigned w (0); w < VThreads.size (); ++w)
+			VThreads [w].join ();
+
+	}// ParallelFor ()
+
+	/**
+	* \fn AtomicOrMaskBits (CMask& Mask, const unsigned& Index, const unsigned long long& Bits)
+	* \brief function to set in a bitmask shared by several threads the bits of several consecutive cells, @see OrMaskBits.
+	*/
+	inline void AtomicOrMaskBits (CMask& Mask, const unsigned& Index, const unsigned long long& Bits)
+	{
+		if (!Bits) return;
+
+		const unsigned Word  = Index / KMaskBits;
+		const unsigned Shift = Index % KMaskBits;
+		__atomic_fetch_or (&Mask [Word], Bits << Shift, __ATOMIC_RELAXED);
+		if (Shift && (Bits >> (KMaskBits - Shift)))
+			__atomic_fetch_or (&Mask [Word + 1], Bits >> (KMaskBits - Shift), __ATOMIC_RELAXED);
+
+	}// AtomicOrMaskBits ()
+
+	/**
+	* \fn FindTileMask (const CBoard& Grid, CMask& Cleared, const unsigned& NbThreads, CVLine* VTiles = NULL)
+	* \brief function to set the bit of every cell belonging to a sequence of 3 numbers, tile by tile in parallel.
+	*
+	* A tile compares, with the kernel of FindMatchMask, the windows of 3 cells starting in it :
+	* a window may end in the next tile, and the words of Cleared shared by two tiles are written
+	* with an atomic OR. The result is the one of FindMatchMask.
+	*
+	*\param Grid : Matrix, its border holding KImpossible
+	*\param Cleared : the bitmask of the cells, sized to the matrix
+	*\param NbThreads : how many threads, 0 for one per core
+	*\param VTiles : if not NULL, only the tiles not 0 are read, and each of them is set to 1 if a sequence starts in it, else 0
+	*/
+	void FindTileMask (const CBoard& Grid, CMask& Cleared, const unsigned& NbThreads, CVLine* VTiles = NULL)
+	{
+		CPhaseClock Clock (KPhaseDetection);
+		const CEqual3Kernel Kernel = Equal3Kernel ();
+		const unsigned Heigth = Grid.GetHeigth ();
+		const unsigned Width  = Grid.GetWidth ();
+		const unsigned NbTileRows		= (Heigth - 2 + KTileRows - 1) / KTileRows;
+		const unsigned NbTileColumns	= (Width - 2 + KTileColumns - 1) / KTileColumns;
+		Cleared.assign ((Heigth * Width + KMaskBits - 1) / KMaskBits, 0);
+
+		ParallelFor (NbTileRows * NbTileColumns, NbThreads, [&] (const unsigned Tile)
+		{
+			if (VTiles && !(*VTiles) [Tile]) return;
+
+			const unsigned Top		= 1 + Tile / NbTileColumns * KTileRows;
+			const unsigned Left		= 1 + Tile % NbTileColumns * KTileColumns;
+			const unsigned Bottom	= min (Top + KTileRows, Heigth - 1);
+			const unsigned Right	= min (Left + KTileColumns, Width - 1);
+			unsigned long long IsFound (0);
+
+			//rows : the windows start between the column Left and the column Width - 4
+			const unsigned NbWindows = Width > 3 + Left ? min (Right, Width - 3) - Left : 0;
+			for (unsigned i (Top); i < Bottom; ++i)
+			{
+				const char* Row = Grid [i] + Left;
+				for (unsigned k (0); k < NbWindows; k += KLanes)
+				{
+					const unsigned long long Bits = (k + KLanes <= NbWindows)
+												  ? Kernel (Row + k, Row + k + 1, Row + k + 2)
+												  : Equal3Partial (Row + k, Row + k + 1, Row + k + 2, NbWindows - k);
+					const unsigned Index = i * Width + Left + k;
+					AtomicOrMaskBits (Cleared, Index,     Bits);
+					AtomicOrMaskBits (Cleared, Index + 1, Bits);
+					AtomicOrMaskBits (Cleared, Index + 2, Bits);
+					IsFound |= Bits;
+				}
+			}
+
+			//columns : the windows start between the row Top and the row Heigth - 4
+			const unsigned NbCells = Right - Left;
+			for (unsigned i (Top); i < Bottom && i + 3 < Heigth; ++i)
+			{
+				const char* Row = Grid [i] + Left;
+				for (unsigned k (0); k < NbCells; k += KLanes)
+				{
+					const unsigned long long Bits = (k + KLanes <= NbCells)
+												  ? Kernel (Row + k, Row + k + Width, Row + k + 2 * Width)
+												  : Equal3Partial (Row + k, Row + k + Width, Row + k + 2 * Width, NbCells - k);
+					const unsigned Index = i * Width + Left + k;
+					AtomicOrMaskBits (Cleared, Index,             Bits);
+					AtomicOrMaskBits (Cleared, Index + Width,     Bits);
+					AtomicOrMaskBits (Cleared, Index + 2 * Width, Bits);
+					IsFound |= Bits;
+				}
+			}
+			if (VTiles) (*VTiles) [Tile] = 0 != IsFound;
+		});
+
+	}// FindTileMask ()
+
+	/**
+	* \fn RefillTiles (CBoard& Grid, const CMask& Cleared, const CVLine& VTiles, const CVLine& Vect, const unsigned long long& Seed, const unsigned& NbThreads)
+	* \brief function to draw again the cells of a bitmask, tile by tile in parallel.
+	*
+	* The bitmask is read a word at a time : the cells not drawn again are skipped 64 at once.
+	* The numbers do not fall : on a tall matrix, the falls would move whole columns and
+	* make as many new sequences as they remove, and the fill would never end. The cells of the
+	* tile number t are drawn row after row from a generator seeded with DeriveSeed (Seed, t) :
+	* the matrix does not depend on the number of threads.
+	*
+	*\param Grid : Matrix
+	*\param Cleared : the cells to draw again, only the ones of the matrix without its border are read
+	*\param VTiles : the tiles holding cells to draw again, 1 per tile
+	*\param Vect : the numbers used to fill the matrix
+	*\param Seed : seed of the pass
+	*\param NbThreads : how many threads, 0 for one per core
+	*/
+	void RefillTiles (CBoard& Grid, const CMask& Cleared, const CVLine& VTiles, const CVLine& Vect, const unsigned long long& Seed, const unsigned& NbThreads)
+	{
+		CPhaseClock Clock (KPhaseFill);
+		const unsigned Heigth = Grid.GetHeigth ();
+		const unsigned Width  = Grid.GetWidth ();
+		const unsigned NbTileColumns = (Width - 2 + KTileColumns - 1) / KTileColumns;
+
+		ParallelFor (VTiles.size (), NbThreads, [&] (const unsigned Tile)
+		{
+			if (!VTiles [Tile]) return;
+
+			const unsigned Top		= 1 + Tile / NbTileColumns * KTileRows;
+			const unsigned Left		= 1 + Tile % NbTileColumns * KTileColumns;
+			const unsigned Bottom	= min (Top + KTileRows, Heigth - 1);
+			const unsigned Right	= min (Left + KTileColumns, Width - 1);
+			CRandom Random (DeriveSeed (Seed, Tile));
+			char* Cells = Grid.GetData ();
+			for (unsigned i (Top); i < Bottom; ++i)
+			{
+				const unsigned Begin = i * Width + Left;
+				const unsigned End	 = i * Width + Right;
+				for (unsigned w (Begin / KMaskBits); w * KMaskBits < End; ++w)
+				{
+					unsigned long long Bits = Cleared [w];
+					if (w == Begin / KMaskBits)
+						Bits &= ~0ULL << (Begin % KMaskBits);
+					if ((w + 1) * KMaskBits > End)
+						Bits &= ~(~0ULL << (End % KMaskBits));
+					for ( ; Bits; Bits &= Bits - 1)
+						Cells [w * KMaskBits + __builtin_ctzll (Bits)] = Vect [Random.Next (Vect.size ())];
+				}
+			}
+		});
+
+	}// RefillTiles ()
+
+	/**
+	* \fn StabilizeTiles (CBoard& Grid, const CVLine& Vect, CRandom& Random, const unsigned& NbThreads)
+	* \brief function to fill a large board until it holds no sequence of 3 numbers, tile by tile in parallel.
+	*
+	* Each pass draws its seed from Random, then draws again with RefillTiles the cells of the
+	* sequences, every cell at the first pass, and looks for the new sequences with FindTileMask :
+	* the matrix only depends on Random. After the first pass, only the tiles drawn again and
+	* their neighbours are read. Besides the matrix, a pass only uses a bitmask, one bit per
+	* cell, and a byte per tile.
+	*
+	*\param Grid : Matrix, its empty cells being filled
+	*\param Vect : the numbers used to fill the matrix
+	*\param Random : random generator
+	*\param NbThreads : how many threads, 0 for one per core
+	*/
+	void StabilizeTiles (CBoard& Grid, const CVLine& Vect, CRandom& Random, const unsigned& NbThreads)
+	{
+		const int NbTileRows	= (Grid.GetHeigth () - 2 + KTileRows - 1) / KTileRows;
+		const int NbTileColumns	= (Grid.GetWidth () - 2 + KTileColumns - 1) / KTileColumns;
+		CMask Cleared ((Grid.GetHeigth () * Grid.GetWidth () + KMaskBits - 1) / KMaskBits, ~0ULL);
+		CVLine VTiles (NbTileRows * NbTileColumns, 1), VNear (VTiles.size ());
+		for ( ; ; )
+		{
+			RefillTiles (Grid, Cleared, VTiles, Vect, Random.Next (), NbThreads);
+
+			//a sequence reaches 2 cells out of a tile : the new ones are in the tiles drawn again or next to them
+			for (int i (0); i < NbTileRows; ++i)
+				for (int j (0); j < NbTileColumns; ++j)
+				{
+					char IsNear (0);
+					for (int k (max (i - 1, 0)); k <= min (i + 1, NbTileRows - 1); ++k)
+						for (int l (max (j - 1, 0)); l <= min (j + 1, NbTileColumns - 1); ++l)
+							IsNear |= VTiles [k * NbTileColumns + l];
+					VNear [i * NbTileColumns + j] = IsNear;
+				}
+			VTiles.swap (VNear);
+
+			FindTileMask (Grid, Cleared, NbThreads, &VTiles);
+			if (find (VTiles.begin (), VTiles.end (), 1) == VTiles.end ()) break;
+		}
+
+	}// StabilizeTiles ()
+
+					/**
+					* \fn bool : Test_StabilizeTiles ()
+					* \brief test function @see FindTileMask, cross-checked with FindMatchMask, and StabilizeTiles, whatever the number of threads.
+					*/
+					bool Test_StabilizeTiles ()
+					{
+						CVLine VCandies;
+						VCandies.push_back ('1');
+						VCandies.push_back ('2');
+						VCandies.push_back ('3');
+
+						unsigned NbErrors (0);
+						for (unsigned Test (0); Test < 20; ++Test)
+						{
+							//matrices of several tiles, the last ones partial, with empty cells
+							CBoard Grid;
+							InitGrid (Grid, 3 + rand () % (3 * KTileColumns), 3 + rand () % (3 * KTileRows));
+							CRandom Random (Test);
+							FillGrid (Grid, VCandies, Random);
+							for (unsigned k (0); k < 10; ++k)
+								Grid [1 + Random.Next (Grid.GetHeigth () - 2)][1 + Random.Next (Grid.GetWidth () - 2)] = KImpossible;
+
+							CMask Expected, Cleared;
+							FindMatchMask (Grid, Expected);
+							FindTileMask (Grid, Cleared, 1 + Test % 4);
+							if (Cleared != Expected) ++NbErrors;
+
+							CBoard Other (Grid);
+							CRandom OtherRandom (Random);
+							StabilizeTiles (Grid, VCandies, Random, 1);
+							StabilizeTiles (Other, VCandies, OtherRandom, 4);
+							FindMatchMask (Grid, Cleared);
+							if (Grid != Other || !IsMaskEmpty (Cleared) || IsValueInGrid (Grid, KImpossible)) ++NbErrors;
+						}
+						return ReportTest ("Test_StabilizeTiles", NbErrors);
+
+					}// Test_StabilizeTiles ()
+
+	/**
+	* \fn StabilizeGrid (CBoard& Grid, const CVLine& Vect, CRandom& Random)
+	* \brief function to fill a matrix until it holds no sequence of 3 numbers.
+	*
+	* A large board is filled by StabilizeTiles, on every core.
+	*
+	*\param Grid : Matrix
+	*\param Vect : the numbers used to fill the matrix
+	*\param Random : random generator
+	*/
+	void StabilizeGrid (CBoard& Grid, const CVLine& Vect, CRandom& Random)
+	{
+		if (IsLargeBoard (Grid))
+		{
+			StabilizeTiles (Grid, Vect, Random, 0);
+			return;
+		}
+
+		CVUInt VNbEmpty;
+		CVPair VPosCol, VPosRow;
+		CVUInt VHowManyCol, VHowManyRow;
+		FillGrid (Grid, Vect, Random);
+		for ( ; ; )
+		{
+			VPosCol.clear ();
+			VPosRow.clear ();
+			VHowManyCol.clear ();
+			VHowManyRow.clear ();
+
+			HandleGrid (Grid, VPosCol, VPosRow, VHowManyCol, VHowManyRow);
+			if (VPosCol.empty () && VPosRow.empty ()) break;
+
+			MoveNumbersDown (Grid, VNbEmpty);
+			FillGrid (Grid, Vect, Random, VNbEmpty);
+		}
+
+	}// StabilizeGrid ()
+
+	/**
+	* \fn unsigned : CountSame <TShape> (const CBoard& Grid, int Row, int Col, const int& DRow, const int& DCol, const char& Value, const CPosition& Skip)
+	* \brief function to count, at most 2, the cells holding Value from (Row, Col) in the direction (DRow, DCol).
+	*
+	* The cell Skip is the other cell of the swap : it no longer holds Value.
+	*/
+	template <typename TShape = CAnyShape>
+	inline unsigned CountSame (const CBoard& Grid, int Row, int Col,
+							   const int& DRow, const int& DCol,
+							   const char& Value, const CPosition& Skip)
+	{
+		unsigned Count (0);
+		for ( ; Count < 2; ++Count)
+		{
+			Row += DRow;
+			Col += DCol;
+			if (unsigned (Row) == Skip.first && unsigned (Col) == Skip.second) break;
+			if (!IsSameColor (TShape::Get (Grid, Row, Col), Value)) break;
+		}
+
+		return Count;
+
+	}// CountSame ()
+
+	/**
+	* \fn bool : MakesSequence <TShape> (const CBoard& Grid, const CPosition& To, const char& Value, const CPosition& From)
+	* \brief function to test if Value, moved from From to To, makes a sequence of 3 numbers.
+	*
+	* Only the 5 cells of the row and of the column centred on To are read.
+	*/
+	template <typename TShape = CAnyShape>
+	inline bool MakesSequence (const CBoard& Grid, const CPosition& To, const char& Value, const CPosition& From)
+	{
+		if (KImpossible == Value) return false;
+
+		const int Row = To.first, Col = To.second;
+		return 2 <= CountSame <TShape> (Grid, Row, Col, 0, -1, Value, From) + CountSame <TShape> (Grid, Row, Col, 0, 1, Value, From)
+			|| 2 <= CountSame <TShape> (Grid, Row, Col, -1, 0, Value, From) + CountSame <TShape> (Grid, Row, Col, 1, 0, Value, From);
+
+	}// MakesSequence ()
+
+	/**
+	* \fn bool : IsMatchingMove <TShape> (const CBoard& Grid, const CPosition& Pos, const char& Direction)
+	* \brief function to test, without playing it, if a move makes at least one sequence.
+	*/
+	template <typename TShape = CAnyShape>
+	bool IsMatchingMove (const CBoard& Grid, const CPosition& Pos, const char& Direction)
+	{
+		CPosition Neighbour;
+		if (!GetNeighbour (Pos, Direction, Neighbour)) return false;
+
+		const char Value	 = TShape::Get (Grid, Pos.first, Pos.second);
+		const char NextValue = TShape::Get (Grid, Neighbour.first, Neighbour.second);
+		if (IsSameColor (Value, NextValue)) return false;
+
+		return MakesSequence <TShape> (Grid, Neighbour, Value, Pos) || MakesSequence <TShape> (Grid, Pos, NextValue, Neighbour);
+
+	}// IsMatchingMove ()
+
+	/**
+	* \fn ListMatchingMoves <TShape> (const CBoard& Grid, CVMove& VMoves)
+	* \brief function to list every move making at least one sequence.
+	*
+	* Each swap is listed once, towards the right ('D') or the bottom ('S').
+	*/
+	template <typename TShape = CAnyShape>
+	void ListMatchingMoves (const CBoard& Grid, CVMove& VMoves)
+	{
+		const unsigned Heigth = TShape::GetHeigth (Grid);
+		const unsigned Width  = TShape::GetWidth (Grid);
+
+		VMoves.clear ();
+		for (unsigned i (1); i < Heigth - 1; ++i)
+			for (unsigned j (1); j < Width - 1; ++j)
+			{
+				CMove Move;
+				Move.Pos = CPosition (i, j);
+
+				Move.Direction = 'D';
+				if (j < Width - 2 && IsMatchingMove <TShape> (Grid, Move.Pos, Move.Direction))
+					VMoves.push_back (Move);
+				Move.Direction = 'S';
+				if (i < Heigth - 2 && IsMatchingMove <TShape> (Grid, Move.Pos, Move.Direction))
+					VMoves.push_back (Move);
+			}
+
+	}// ListMatchingMoves ()
+
+	/**
+	* \fn bool : FindHint <TShape> (const CBoard& Grid, CMove& Move)
+	* \brief function to find a move making at least one sequence, stopping at the first one.
+	*
+	*\return false if the matrix is dead : no move makes a sequence
+	*/
+	template <typename TShape = CAnyShape>
+	bool FindHint (const CBoard& Grid, CMove& Move)
+	{
+		const unsigned Heigth = TShape::GetHeigth (Grid);
+		const unsigned Width  = TShape::GetWidth (Grid);
+
+		for (unsigned i (1); i < Heigth - 1; ++i)
+			for (unsigned j (1); j < Width - 1; ++j)
+			{
+				Move.Pos = CPosition (i, j);
+
+				Move.Direction = 'D';
+				if (j < Width - 2 && IsMatchingMove <TShape> (Grid, Move.Pos, Move.Direction))
+					return true;
+				Move.Direction = 'S';
+				if (i < Heigth - 2 && IsMatchingMove <TShape> (Grid, Move.Pos, Move.Direction))
+					return true;
+			}
+
+		return false;
+
+	}// FindHint ()
+
+	/**
+	* \fn bool : ShuffleGrid (CBoard& Grid, const CVLine& Vect, CRandom& Random, CTurnScratch& Scratch)
+	* \brief function to shuffle a dead matrix until it holds no sequence but at least one move making one.
+	*
+	* After KMaxShuffles tries, the matrix is filled again.
+	*
+	*\param Scratch : buffers sized by InitTurnScratch
+	*\return false if no matrix with a move was found
+	*/
+	bool ShuffleGrid (CBoard& Grid, const CVLine& Vect, CRandom& Random, CTurnScratch& Scratch)
+	{
+		CMove Hint;
+		CVLine& VCells = Scratch.VCells;
+		CMask& Cleared = Scratch.Cleared;
+		for (unsigned Try (0); Try < KMaxShuffles; ++Try)
+		{
+			VCells.clear ();
+			for (unsigned i (1); i < Grid.GetHeigth () - 1; ++i)
+				VCells.insert (VCells.end (), Grid [i] + 1, Grid [i] + Grid.GetWidth () - 1);
+
+			for (unsigned k = VCells.size (); k > 1; --k)
+				swap (VCells [k - 1], VCells [Random.Next (k)]);
+
+			for (unsigned i (1), k (0); i < Grid.GetHeigth () - 1; ++i, k += Grid.GetWidth () - 2)
+				copy (VCells.begin () + k, VCells.begin () + k + Grid.GetWidth () - 2, Grid [i] + 1);
+
+			FindMatchMask (Grid, Cleared);
+			if (IsMaskEmpty (Cleared) && FindHint (Grid, Hint)) return true;
+		}
+
+		for (unsigned Try (0); Try < KMaxShuffles; ++Try)
+		{
+			InitGrid (Grid, Grid.GetWidth (), Grid.GetHeigth ());
+			StabilizeGrid (Grid, Vect, Random);
+			if (FindHint (Grid, Hint)) return true;
+		}
+
+		return false;
+
+	}// ShuffleGrid ()
+
+	/**
+	* \fn const CRules& : ShapeRules <TShape> ()
+	* \brief function to get the core rules instantiated for TShape.
+	*/
+	template <typename TShape>
+	const CRules& ShapeRules ()
+	{
+		static const CRules Rules = { &IsMatchingMove <TShape>, &ListMatchingMoves <TShape>,
+									  &FindHint <TShape>, &ResolveCascade <TShape> };
+		return Rules;
+
+	}// ShapeRules ()
+
+	/**
+	* \fn const CRules& : SelectRules (const CGameConfig& Config)
+	* \brief function to pick the rules specialized for the size of a game, the generic ones otherwise.
+	*
+	* Specialized : the default 10x10 matrix with 4 to 6 numbers, and the classic 8x8 with 6 numbers.
+	*/
+	const CRules& SelectRules (const CGameConfig& Config)
+	{
+		if (10 == Config.MatHeigth && 10 == Config.MatWidth)
+			switch (Config.NbCandies)
+			{
+				case 4: return ShapeRules <CShape <10, 10, 4> > ();
+				case 5: return ShapeRules <CShape <10, 10, 5> > ();
+				case 6: return ShapeRules <CShape <10, 10, 6> > ();
+			}
+		if (8 == Config.MatHeigth && 8 == Config.MatWidth && 6 == Config.NbCandies)
+			return ShapeRules <CShape <8, 8, 6> > ();
+
+		return ShapeRules <CAnyShape> ();
+
+	}// SelectRules ()
+
+	/**
+	* \fn LoadGameConfig (const CConfig& Settings, CGameConfig& Config)
+	* \brief function to get the settings of a game from the config.
+	*/
+	void LoadGameConfig (const CConfig& Settings, CGameConfig& Config)
+	{
+		Config.MatHeigth	= Settings.Get ("MatrixHeigth");
+		Config.MatWidth		= Settings.Get ("MatrixWidth");
+		Config.NbCandies	= Settings.Get ("NbCandies");
+		Config.NbMaxTimes	= Settings.Get ("NbMaxTimes");
+		Config.IsBitBoard	= 0 != Settings.Get ("BitBoard");
+		Config.IsSpecials	= 0 != Settings.Get ("Specials");
+
+	}// LoadGameConfig ()
+
+	/**
+	* \fn InitGame (CGame& Game, const CGameConfig& Config, const unsigned long long& Seed)
+	* \brief function to start a game : the matrix is filled and holds no sequence.
+	*
+	*\param Game : the game
+	*\param Config : the settings
+	*\param Seed : the seed of the game, every refill of the matrix only depends on it
+	*/
+	void InitGame (CGame& Game, const CGameConfig& Config, const unsigned long long& Seed)
+	{
+		Game.Random.SetSeed (Seed);
+
+		Game.VCandies.resize (Config.NbCandies);
+		for (unsigned i = (0); i < Game.VCandies.size (); ++i)
+			Game.VCandies [i] = char ('0' + i + 1);
+
+		InitGrid (Game.Grid, Config.MatWidth + 2, Config.MatHeigth + 2);
+		StabilizeGrid (Game.Grid, Game.VCandies, Game.Random);
+		InitDirtyRegion (Game.Dirty, Game.Grid);
+		InitTurnScratch (Game.Scratch, Game.Grid);
+		Game.Rules = &SelectRules (Config);
+
+		Game.TotalScore = Game.TurnScore = Game.Multiplier = 0;
+		Game.NbMovesLeft = Config.NbMaxTimes;
+
+		CMove Hint;
+		Game.IsShuffled = !Game.Rules->FindHint (Game.Grid, Hint) && ShuffleGrid (Game.Grid, Game.VCandies, Game.Random, Game.Scratch);
+
+		Game.IsSpecials = Config.IsSpecials;
+		Game.IsBitBoard = Config.IsBitBoard && CBitBoard::Fits (Config.MatHeigth, Config.MatWidth, Config.NbCandies);
+		if (Game.IsBitBoard)
+			Game.Bits.FromBoard (Game.Grid, Config.NbCandies);
+
+	}// InitGame ()
+
+	/**
+	* \fn bool : IsMoveValid (const CGame& Game, const CPosition& Pos, const char& Direction)
+	* \brief function to test if a move swaps two different numbers of the matrix.
+	*/
+	bool IsMoveValid (const CGame& Game, const CPosition& Pos, const char& Direction)
+	{
+		const CBoard& Grid = Game.Grid;
+
+		CPosition Neighbour;
+		if (!GetNeighbour (Pos, Direction, Neighbour)) return false;
+
+		if (!IsBetween (Pos.first, 1u, Grid.GetHeigth () - 2) || !IsBetween (Pos.second, 1u, Grid.GetWidth () - 2))
+			return false;
+		if (!IsBetween (Neighbour.first, 1u, Grid.GetHeigth () - 2) || !IsBetween (Neighbour.second, 1u, Grid.GetWidth () - 2))
+			return false;
+
+		return !IsSameColor (Grid [Pos.first][Pos.second], Grid [Neighbour.first][Neighbour.second]);
+
+	}// IsMoveValid ()
+
+					/**
+					* \fn bool : Test_IsMoveValid ()
+					* \brief test function @see IsMoveValid : a special cell and a plain cell of the same number are not different numbers.
+					*/
+					bool Test_IsMoveValid ()
+					{
+						CGame Game;
+						InitGrid (Game.Grid, 5, 5);
+						const char VRow [] = { '1', MakeSpecial ('1', KSpecialColumn), '2' };
+						copy (VRow, VRow + 3, Game.Grid [1] + 1);
+						copy (VRow, VRow + 3, Game.Grid [2] + 1);
+
+						unsigned NbErrors (0);
+						if (IsMoveValid (Game, CPosition (1, 1), 'D')) ++NbErrors;
+						if (!IsMoveValid (Game, CPosition (1, 2), 'D')) ++NbErrors;
+						if (IsMoveValid (Game, CPosition (1, 2), 'S')) ++NbErrors;
+						if (IsMoveValid (Game, CPosition (1, 3), 'D')) ++NbErrors;	//the border
+						return ReportTest ("Test_IsMoveValid", NbErrors);
+
+					}// Test_IsMoveValid ()
+
+	/**
+	* \fn ResolveMove (CGame& Game, const CPosition& Pos, const char& Direction, CUndoLog* Log = NULL, CVUInt* VSteps = NULL)
+	* \brief function to swap two cells and resolve the cascade, on Game.Bits when IsBitBoard.
+	*
+	* The steps of an animation are only recorded on the matrix : with VSteps, the cascade is
+	* resolved by ResolveCascade and the bitboards are built again from the matrix.
+	*
+	*\param Log : records every changed cell, if not NULL
+	*\param VSteps : receives the checkpoint of Log after each step of the move, if not NULL
+	*/
+	void ResolveMove (CGame& Game, const CPosition& Pos, const char& Direction, CUndoLog* Log = NULL, CVUInt* VSteps = NULL)
+	{
+		BeginMoveStats ();
+		MakeAMove (Game.Grid, Pos, Direction, Log);
+		MarkStep (Log, VSteps);
+
+		CPosition VMoved [2] = { Pos };
+		GetNeighbour (Pos, Direction, VMoved [1]);
+		const CPosition& Neighbour = VMoved [1];
+
+		Game.TurnScore = Game.Multiplier = 0;
+		if (Game.IsBitBoard && !VSteps)
+		{
+			Game.Bits.Swap (Pos, Neighbour);
+
+			//most moves tried by a search make no sequence : the two swapped cells are checked first
+			const CBoard& Grid = Game.Grid;
+			if (MakesSequence (Grid, Pos, Grid [Pos.first][Pos.second], Neighbour)
+			 || MakesSequence (Grid, Neighbour, Grid [Neighbour.first][Neighbour.second], Pos))
+				ResolveBitCascade (Game.Bits, Game.Random, Pos, Neighbour, Game.TurnScore, Game.Multiplier, Game.IsSpecials, Game.Grid, Log);
+			return;
+		}
+
+		MarkMoveDirty (Game.Dirty, Pos, Direction);
+		Game.Rules->ResolveCascade (Game.Grid, Game.VCandies, Game.Random, Game.Dirty, Game.Scratch, Game.TurnScore, Game.Multiplier,
+									Game.IsSpecials ? VMoved : NULL, Log, VSteps);
+		if (Game.IsBitBoard)
+			Game.Bits.FromBoard (Game.Grid, Game.VCandies.size ());
+
+	}// ResolveMove ()
+
+	/**
+	* \fn PlayMove (CGame& Game, const CPosition& Pos, const char& Direction, CUndoLog* Log = NULL, CVUInt* VSteps = NULL)
+	* \brief function to play a valid move : swap, cascade and score.
+	*
+	*\param Log : records every changed cell, if not NULL
+	*\param VSteps : receives the checkpoint of Log after each step of the move, @see CAnimation
+	*/
+	void PlayMove (CGame& Game, const CPosition& Pos, const char& Direction, CUndoLog* Log = NULL, CVUInt* VSteps = NULL)
+	{
+		ResolveMove (Game, Pos, Direction, Log, VSteps);
+		CountTurn (Game.Multiplier);
+
+		Game.TotalScore += Game.TurnScore * Game.Multiplier;
+		--Game.NbMovesLeft;
+
+		//dead matrix detection
+		CMove Hint;
+		Game.IsShuffled = false;
+		if (!Game.Rules->FindHint (Game.Grid, Hint))
+		{
+			for (unsigned i (1); i < Game.Grid.GetHeigth () - 1; ++i)
+				for (unsigned j (1); j < Game.Grid.GetWidth () - 1; ++j)
+					LogCell (Log, Game.Grid, Game.Grid [i][j]);
+
+			Game.IsShuffled = ShuffleGrid (Game.Grid, Game.VCandies, Game.Random, Game.Scratch);
+			MarkStep (Log, VSteps);
+			if (Game.IsBitBoard)
+				Game.Bits.FromBoard (Game.Grid, Game.VCandies.size ());
+		}
+
+	}// PlayMove ()
+
+	/**
+	* \fn unsigned : PlayGame (CGame& Game, const CMovePolicy& Policy)
+	* \brief function to play the moves of a policy until no move is left.
+	*
+	*\return the final score
+	*/
+	unsigned PlayGame (CGame& Game, const CMovePolicy& Policy)
+	{
+		for ( ; 0 != Game.NbMovesLeft; )
+		{
+			CPosition Pos;
+			char Direction;
+			if (!Policy (Game, Pos, Direction) || !IsMoveValid (Game, Pos, Direction)) break;
+
+			PlayMove (Game, Pos, Direction);
+		}
+
+		return Game.TotalScore;
+
+	}// PlayGame ()
+
+	/**
+	* \fn bool : PickRandomMove (const CGame& Game, CRandom& Random, CPosition& Pos, char& Direction)
+	* \brief function to draw a random valid move.
+	*
+	*\return false if no valid move was found
+	*/
+	bool PickRandomMove (const CGame& Game, CRandom& Random, CPosition& Pos, char& Direction)
+	{
+		const unsigned NbRows = Game.Grid.GetHeigth () - 2;
+		const unsigned NbCols = Game.Grid.GetWidth ()  - 2;
+
+		for (unsigned Try (0); Try < 64 * NbRows * NbCols; ++Try)
+		{
+			Pos = CPosition (1 + Random.Next (NbRows), 1 + Random.Next (NbCols));
+			Direction = KDirections [Random.Next (4)];
+			if (IsMoveValid (Game, Pos, Direction)) return true;
+		}
+
+		return false;
+
+	}// PickRandomMove ()
+
+					/**
+					* \fn bool : Test_PlayMoveAllocations ()
+					* \brief test function @see PlayMove, CutInputStr : after warm-up, a turn allocates nothing, animated or on a CBitBoard.
+					*/
+					bool Test_PlayMoveAllocations ()
+					{
+						CGameConfig Config = MakeTestConfig (10, 10, 5, 2000, true);
+
+						CGame Game;
+						InitGame (Game, Config, 42);
+						CRandom Random (7);
+						CUndoLog Log;
+						CVUInt VSteps;
+						VSteps.reserve (256);	//the special cells may make a cascade longer than the warm-up ones
+						const string VInputs [] = { "3 4 d", "  10   1  z ", "7 x Q", "12" };
+
+						unsigned NbErrors (0);
+						for (unsigned Turn (0); 0 != Game.NbMovesLeft; ++Turn)
+						{
+							CPosition Pos;
+							char Direction;
+							if (!PickRandomMove (Game, Random, Pos, Direction)) break;
+
+							const unsigned long long NbAllocations = AllocationCount ();
+							CPosition InputPos (0, 0);
+							char InputDir;
+							CutInputStr (VInputs [Turn % 4], InputPos, InputDir);
+
+							Log.Clear ();
+							VSteps.clear ();
+							PlayMove (Game, Pos, Direction, &Log, &VSteps);
+							if (100 <= Turn && AllocationCount () != NbAllocations) ++NbErrors;
+						}
+
+						//the default play of a game : on a CBitBoard, without log nor animation, @see ResolveMove
+						Config.IsBitBoard = true;
+						InitGame (Game, Config, 42);
+						if (!Game.IsBitBoard) ++NbErrors;
+						for (unsigned Turn (0); 0 != Game.NbMovesLeft; ++Turn)
+						{
+							CPosition Pos;
+							char Direction;
+							if (!PickRandomMove (Game, Random, Pos, Direction)) break;
+
+							const unsigned long long NbAllocations = AllocationCount ();
+							PlayMove (Game, Pos, Direction);
+							if (100 <= Turn && AllocationCount () != NbAllocations) ++NbErrors;
+						}
+						return ReportTest ("Test_PlayMoveAllocations", NbErrors);
+
+					}// Test_PlayMoveAllocations ()
+
+					/**
+					* \fn bool : Test_SelectRules ()
+					* \brief test function @see SelectRules : a game played with the specialized rules is the game played with the generic ones.
+					*/
+					bool Test_SelectRules ()
+					{
+						const unsigned VShapes [][3] = { { 10, 10, 4 }, { 10, 10, 5 }, { 10, 10, 6 }, { 8, 8, 6 } };
+
+						unsigned NbErrors (0);
+						for (unsigned s (0); s < sizeof (VShapes) / sizeof (VShapes [0]); ++s)
+						{
+							CGameConfig Config = MakeTestConfig (VShapes [s][0], VShapes [s][1], VShapes [s][2], 100, true);
+							if (&SelectRules (Config) == &ShapeRules <CAnyShape> ()) ++NbErrors;
+
+							for (unsigned Seed (0); Seed < 10; ++Seed)
+							{
+								CGame Fixed, Any;
+								InitGame (Fixed, Config, Seed);
+								InitGame (Any, Config, Seed);
+								Any.Rules = &ShapeRules <CAnyShape> ();
+
+								CRandom Random (Seed);
+								CVMove VFixedMoves, VAnyMoves;
+								for ( ; 0 != Fixed.NbMovesLeft; )
+								{
+									Fixed.Rules->ListMatchingMoves (Fixed.Grid, VFixedMoves);
+									Any.Rules->ListMatchingMoves (Any.Grid, VAnyMoves);
+									if (VFixedMoves.size () != VAnyMoves.size ()) ++NbErrors;
+
+									CPosition Pos;
+									char Direction;
+									if (!PickRandomMove (Fixed, Random, Pos, Direction)) break;
+
+									PlayMove (Fixed, Pos, Direction);
+									PlayMove (Any, Pos, Direction);
+									if (Fixed.Grid != Any.Grid || Fixed.TotalScore != Any.TotalScore) ++NbErrors;
+								}
+							}
+						}
+						return ReportTest ("Test_SelectRules", NbErrors);
+
+					}// Test_SelectRules ()
+
+	/** \class CRandomPolicy
+	 *
+	 * \brief move policy playing a random valid move, with its own generator
+	 *
+	 */
+	class CRandomPolicy
+	{
+		CRandom m_Random;	/*!< \brief generator of the moves */
+
+	  public:
+		explicit CRandomPolicy (const unsigned long long& Seed) : m_Random (Seed) {}
+
+		bool operator () (const CGame& Game, CPosition& Pos, char& Direction)
+		{
+			return PickRandomMove (Game, m_Random, Pos, Direction);
+		}
+
+	};// CRandomPolicy
+
+	/** \struct CSearchStats
+	 *
+	 * \brief what a search policy did
+	 *
+	 */
+	struct CSearchStats
+	{
+		unsigned long long	NbNodes;	/*!< \brief how many moves were played and undone */
+		unsigned			NbMoves;	/*!< \brief how many moves were chosen */
+		double				Seconds;	/*!< \brief time spent choosing them */
+	};
+
+	/** \struct CGameState
+	 *
+	 * \brief what must be saved, besides the cells, to undo a move of a game
+	 *
+	 */
+	struct CGameState
+	{
+		unsigned	TotalScore;		/*!< \brief @see CGame */
+		unsigned	TurnScore;		/*!< \brief @see CGame */
+		unsigned	Multiplier;		/*!< \brief @see CGame */
+		unsigned	NbMovesLeft;	/*!< \brief @see CGame */
+		CRandom		Random;			/*!< \brief @see CGame */
+		unsigned	Mark;			/*!< \brief checkpoint of the undo log */
+	};
+
+	/**
+	* \fn SaveGameState (const CGame& Game, const CUndoLog& Log, CGameState& State)
+	* \brief function to save a game before playing moves that will be undone.
+	*/
+	void SaveGameState (const CGame& Game, const CUndoLog& Log, CGameState& State)
+	{
+		State.TotalScore	= Game.TotalScore;
+		State.TurnScore		= Game.TurnScore;
+		State.Multiplier	= Game.Multiplier;
+		State.NbMovesLeft	= Game.NbMovesLeft;
+		State.Random		= Game.Random;
+		State.Mark			= Log.GetCheckpoint ();
+
+	}// SaveGameState ()
+
+	/**
+	* \fn RestoreGameState (CGame& Game, CUndoLog& Log, const CGameState& State)
+	* \brief function to undo every move played since SaveGameState, in O(changed cells).
+	*
+	* The bitboards always hold the cells of the matrix : they take back the values of the log too.
+	*/
+	void RestoreGameState (CGame& Game, CUndoLog& Log, const CGameState& State)
+	{
+		const unsigned Width = Game.Grid.GetWidth ();
+		for (unsigned i (Log.GetCheckpoint ()); Game.IsBitBoard && i-- > State.Mark; )
+			Game.Bits.Set (Log [i].Offset / Width, Log [i].Offset % Width, Log [i].Value);
+
+		Log.Rollback (Game.Grid, State.Mark);
+		Game.TotalScore		= State.TotalScore;
+		Game.TurnScore		= State.TurnScore;
+		Game.Multiplier		= State.Multiplier;
+		Game.NbMovesLeft	= State.NbMovesLeft;
+		Game.Random			= State.Random;
+
+	}// RestoreGameState ()
+
+	/**
+	* \fn SyncGame (CGame& Copy, const CGame& Game)
+	* \brief function to make a copy of a game equal to the game again, without allocating.
+	*
+	* Only the cells that differ are written, in the matrix and in the bitboards. A game of
+	* other settings, or the first one, is copied whole.
+	*/
+	void SyncGame (CGame& Copy, const CGame& Game)
+	{
+		if (Copy.Rules != Game.Rules || Copy.VCandies != Game.VCandies || Copy.IsBitBoard != Game.IsBitBoard
+		 || Copy.Grid.GetHeigth () != Game.Grid.GetHeigth () || Copy.Grid.GetWidth () != Game.Grid.GetWidth ())
+		{
+			Copy = Game;
+			return;
+		}
+
+		const unsigned Width = Game.Grid.GetWidth ();
+		const char* Cells = Game.Grid.GetData ();
+		char* Copied = Copy.Grid.GetData ();
+		for (unsigned Offset (0); Offset < Game.Grid.GetHeigth () * Width; ++Offset)
+		{
+			if (Copied [Offset] == Cells [Offset]) continue;
+
+			Copied [Offset] = Cells [Offset];
+			if (Copy.IsBitBoard)
+				Copy.Bits.Set (Offset / Width, Offset % Width, Cells [Offset]);
+		}
+
+		Copy.TotalScore		= Game.TotalScore;
+		Copy.TurnScore		= Game.TurnScore;
+		Copy.Multiplier		= Game.Multiplier;
+		Copy.NbMovesLeft	= Game.NbMovesLeft;
+		Copy.Random			= Game.Random;
+		Copy.IsSpecials		= Game.IsSpecials;
+		Copy.IsShuffled		= Game.IsShuffled;
+
+	}// SyncGame ()
+
+	/**
+	* \fn unsigned : ApplyMove (CGame& Game, const CMove& Move, CUndoLog& Log)
+	* \brief function to play a move like PlayMove, recording every changed cell, without reshuffling a dead matrix.
+	*
+	*\return the points won by the move : TurnScore * Multiplier
+	*/
+	unsigned ApplyMove (CGame& Game, const CMove& Move, CUndoLog& Log)
+	{
+		ResolveMove (Game, Move.Pos, Move.Direction, &Log);
+
+		Game.TotalScore += Game.TurnScore * Game.Multiplier;
+		--Game.NbMovesLeft;
+
+		return Game.TurnScore * Game.Multiplier;
+
+	}// ApplyMove ()
+
+					/**
+					* \fn bool : Test_BitBoardCascade ()
+					* \brief test function @see ResolveBitCascade, cross-checked with ResolveCascade on the same games.
+					*/
+					bool Test_BitBoardCascade ()
+					{
+						unsigned NbErrors (0);
+						for (unsigned Test (0); Test < 200; ++Test)
+						{
+							CRandom Random (Test);
+							const unsigned Heigth		= 5 + Random.Next (16);
+							const unsigned Width		= 5 + Random.Next (11);
+							const unsigned NbCandies	= 3 + Random.Next (5);
+							CGameConfig Config = MakeTestConfig (Heigth, Width, NbCandies, 50, 0 != Test % 2);
+
+							CGame Cells, Bits;
+							Config.IsBitBoard = false;
+							InitGame (Cells, Config, Test);
+							Config.IsBitBoard = true;
+							InitGame (Bits, Config, Test);
+							if (!Bits.IsBitBoard) ++NbErrors;
+
+							CUndoLog Log;
+							CGame Copy;
+							for ( ; 0 != Cells.NbMovesLeft; )
+							{
+								CPosition Pos;
+								char Direction;
+								if (!PickRandomMove (Cells, Random, Pos, Direction)) break;
+
+								//a move undone must leave the matrix and the bitboards as they were
+								const CBoard Before (Bits.Grid);
+								CGameState State;
+								CMove Move;
+								Move.Pos		= Pos;
+								Move.Direction	= Direction;
+								SaveGameState (Bits, Log, State);
+								ApplyMove (Bits, Move, Log);
+								RestoreGameState (Bits, Log, State);
+								if (Bits.Grid != Before) ++NbErrors;
+								for (unsigned i (1); i <= Config.MatHeigth; ++i)
+									for (unsigned j (1); j <= Config.MatWidth; ++j)
+										if (Bits.Bits.Get (i, j) != Before [i][j]) ++NbErrors;
+
+								PlayMove (Cells, Pos, Direction);
+								PlayMove (Bits, Pos, Direction);
+								if (Cells.Grid != Bits.Grid || Cells.TotalScore != Bits.TotalScore) ++NbErrors;
+
+								//a copy kept by SyncGame must hold the same cells
+								SyncGame (Copy, Bits);
+								if (Copy.Grid != Bits.Grid || Copy.TotalScore != Bits.TotalScore) ++NbErrors;
+								for (unsigned i (1); i <= Config.MatHeigth; ++i)
+									for (unsigned j (1); j <= Config.MatWidth; ++j)
+										if (Bits.Bits.Get (i, j) != Bits.Grid [i][j] || Copy.Bits.Get (i, j) != Bits.Grid [i][j]) ++NbErrors;
+							}
+						}
+						return ReportTest ("Test_BitBoardCascade", NbErrors);
+
+					}// Test_BitBoardCascade ()
+
+	/** \class CSearchPolicy
+	 *
+	 * \brief base of the move policies searching the moves of a copy of the game.
+	 *
+	 * The copy of the game is made equal to the game by SyncGame for each move to choose;
+	 * the moves tried are then played and undone with an undo log. The refills are drawn from the generator of the
+	 * policy, never from the one of the game.
+	 *
+	 */
+	class CSearchPolicy
+	{
+	  protected:
+		CRandom								m_Random;	/*!< \brief generator of the refills tried */
+		unsigned							m_BudgetMs;	/*!< \brief time to choose a move, 0 for no limit */
+		chrono::steady_clock::time_point	m_Deadline;	/*!< \brief end of the time to choose the current move */
+		CSearchStats						m_Stats;	/*!< \brief counters */
+		CGame								m_Game;		/*!< \brief copy of the game the moves are tried on, kept from one move to the next */
+		CUndoLog							m_Log;		/*!< \brief changes of the cells of m_Game */
+		CVMove								m_VMoves;	/*!< \brief the moves making a sequence at the root */
+
+		bool IsTimeUp () const { return m_BudgetMs && chrono::steady_clock::now () >= m_Deadline; }
+
+		/**
+		* \fn unsigned : TryMove (const CMove& Move, const unsigned long long& Seed)
+		* \brief function to play a move on m_Game with refills drawn from Seed, to undo it later.
+		*/
+		unsigned TryMove (const CMove& Move, const unsigned long long& Seed)
+		{
+			++m_Stats.NbNodes;
+			m_Game.Random.SetSeed (Seed);
+			return ApplyMove (m_Game, Move, m_Log);
+		}
+
+		virtual bool ChooseMove (CMove& Move) = 0;
+
+	  public:
+		CSearchPolicy (const unsigned long long& Seed, const unsigned& BudgetMs)
+			: m_Random (Seed), m_BudgetMs (BudgetMs)
+		{
+			m_Stats.NbNodes = m_Stats.NbMoves = 0;
+			m_Stats.Seconds = 0;
+		}
+		virtual ~CSearchPolicy () {}
+
+		const CSearchStats& GetStats () const { return m_Stats; }
+
+		bool operator () (const CGame& Game, CPosition& Pos, char& Direction)
+		{
+			const chrono::steady_clock::time_point Begin = chrono::steady_clock::now ();
+			m_Deadline = Begin + chrono::milliseconds (m_BudgetMs);
+
+			SyncGame (m_Game, Game);
+			m_Log.Clear ();
+			m_VMoves.reserve (2 * Game.Grid.GetHeigth () * Game.Grid.GetWidth ());	//at most two moves per cell : the list does not grow from one move to the next
+			m_Game.Rules->ListMatchingMoves (m_Game.Grid, m_VMoves);
+
+			CMove Move;
+			const bool IsFound = m_VMoves.empty () ? PickRandomMove (Game, m_Random, Move.Pos, Move.Direction)
+												   : ChooseMove (Move);
+			Pos = Move.Pos;
+			Direction = Move.Direction;
+
+			++m_Stats.NbMoves;
+			m_Stats.Seconds += chrono::duration <double> (chrono::steady_clock::now () - Begin).count ();
+			return IsFound;
+		}
+
+	};// CSearchPolicy
+
+	/** \class CGreedyPolicy
+	 *
+	 * \brief move policy playing the move winning the most points right now (TurnScore * Multiplier)
+	 *
+	 */
+	class CGreedyPolicy : public CSearchPolicy
+	{
+	  protected:
+		bool ChooseMove (CMove& Move)
+		{
+			//every move sees the same refills
+			const unsigned long long Seed = m_Random.Next ();
+
+			unsigned Best (0);
+			Move = m_VMoves [0];
+			for (unsigned i (0); i < m_VMoves.size () && !IsTimeUp (); ++i)
+			{
+				CGameState State;
+				SaveGameState (m_Game, m_Log, State);
+				const unsigned Gain = TryMove (m_VMoves [i], Seed);
+				RestoreGameState (m_Game, m_Log, State);
+
+				if (Gain > Best)
+				{
+					Best = Gain;
+					Move = m_VMoves [i];
+				}
+			}
+
+			return true;
+		}
+
+	  public:
+		CGreedyPolicy (const unsigned long long& Seed, const unsigned& BudgetMs) : CSearchPolicy (Seed, BudgetMs) {}
+
+	};// CGreedyPolicy
+
+	/** \class CExpectimaxPolicy
+	 *
+	 * \brief move policy maximizing the points expected in the next moves
+	 *
+	 * After each move, KExpectimaxSamples refills are drawn and their points averaged.
+	 * The depth grows by one move while the time budget allows it, up to KExpectimaxDepth;
+	 * the best move of the last complete depth is played.
+	 *
+	 */
+	class CExpectimaxPolicy : public CSearchPolicy
+	{
+		vector <CVMove>		m_VMovesByDepth;	/*!< \brief the moves tried at each depth */
+		unsigned long long	m_Seed;				/*!< \brief seed of the refills of the current choice */
+		bool				m_IsAborted;		/*!< \brief the time ran out during the current depth */
+
+		/**
+		* \fn double : Expectimax (const unsigned& Depth)
+		* \brief function to get the points expected from m_Game in Depth moves, playing the best ones.
+		*/
+		double Expectimax (const unsigned& Depth)
+		{
+			if (0 == Depth || 0 == m_Game.NbMovesLeft) return 0;
+
+			CVMove& VMoves = m_VMovesByDepth [Depth];
+			m_Game.Rules->ListMatchingMoves (m_Game.Grid, VMoves);
+
+			double Best (0);
+			for (unsigned i (0); i < VMoves.size (); ++i)
+				Best = max (Best, Expectation (VMoves [i], Depth));
+
+			return Best;
+		}
+
+		/**
+		* \fn double : Expectation (const CMove& Move, const unsigned& Depth)
+		* \brief function to get the points expected from a move and the Depth - 1 following ones.
+		*/
+		double Expectation (const CMove& Move, const unsigned& Depth)
+		{
+			double Sum (0);
+			for (unsigned k (0); k < KExpectimaxSamples; ++k)
+			{
+				if (IsTimeUp ())
+				{
+					m_IsAborted = true;
+					return 0;
+				}
+
+				CGameState State;
+				SaveGameState (m_Game, m_Log, State);
+				Sum += TryMove (Move, DeriveSeed (m_Seed, Depth * KExpectimaxSamples + k));
+				Sum += Expectimax (Depth - 1);
+				RestoreGameState (m_Game, m_Log, State);
+			}
+
+			return Sum / KExpectimaxSamples;
+		}
+
+	  protected:
+		bool ChooseMove (CMove& Move)
+		{
+			m_Seed = m_Random.Next ();
+			m_IsAborted = false;
+
+			Move = m_VMoves [0];
+			for (unsigned Depth (1); Depth <= KExpectimaxDepth && Depth <= m_Game.NbMovesLeft; ++Depth)
+			{
+				CMove DepthMove = m_VMoves [0];
+				double Best (-1);
+				for (unsigned i (0); i < m_VMoves.size () && !m_IsAborted; ++i)
+				{
+					const double Value = Expectation (m_VMoves [i], Depth);
+					if (Value > Best)
+					{
+						Best = Value;
+						DepthMove = m_VMoves [i];
+					}
+				}
+				if (m_IsAborted) break;
+
+				Move = DepthMove;
+			}
+
+			return true;
+		}
+
+	  public:
+		CExpectimaxPolicy (const unsigned long long& Seed, const unsigned& BudgetMs)
+			: CSearchPolicy (Seed, BudgetMs), m_VMovesByDepth (KExpectimaxDepth + 1), m_Seed (0), m_IsAborted (false) {}
+
+	};// CExpectimaxPolicy
+
+	/** \class CMonteCarloPolicy
+	 *
+	 * \brief move policy playing the move whose random continuations win the most points
+	 *
+	 * Each move making a sequence is followed by KRolloutHorizon moves drawn at random,
+	 * preferably making a sequence. Rounds of rollouts are played while the time budget
+	 * allows it (KNbRollouts rounds without budget).
+	 *
+	 */
+	class CMonteCarloPolicy : public CSearchPolicy
+	{
+		CRandom	m_RolloutRandom;	/*!< \brief generator of the moves of the rollouts */
+
+		/**
+		* \fn PickRolloutMove (CMove& Move)
+		* \brief function to draw a move of m_Game, making a sequence if one is found quickly.
+		*/
+		bool PickRolloutMove (CMove& Move)
+		{
+			const unsigned NbRows = m_Game.Grid.GetHeigth () - 2;
+			const unsigned NbCols = m_Game.Grid.GetWidth ()  - 2;
+
+			for (unsigned Try (0); Try < 32; ++Try)
+			{
+				Move.Pos = CPosition (1 + m_RolloutRandom.Next (NbRows), 1 + m_RolloutRandom.Next (NbCols));
+				Move.Direction = KDirections [m_RolloutRandom.Next (4)];
+				if (IsMoveValid (m_Game, Move.Pos, Move.Direction) && m_Game.Rules->IsMatchingMove (m_Game.Grid, Move.Pos, Move.Direction))
+					return true;
+			}
+
+			return PickRandomMove (m_Game, m_RolloutRandom, Move.Pos, Move.Direction);
+		}
+
+	  protected:
+		bool ChooseMove (CMove& Move)
+		{
+			const unsigned long long Seed = m_Random.Next ();
+			const unsigned Horizon = min (KRolloutHorizon, m_Game.NbMovesLeft - 1);
+
+			vector <double> VSums (m_VMoves.size (), 0);
+			unsigned Round (0);
+			for ( ; 0 == Round || (m_BudgetMs ? !IsTimeUp () : Round < KNbRollouts); ++Round)
+			{
+				//every move sees the same refills and the same rollout moves during a round
+				const unsigned long long RoundSeed = DeriveSeed (Seed, Round);
+				for (unsigned i (0); i < m_VMoves.size (); ++i)
+				{
+					CGameState State;
+					SaveGameState (m_Game, m_Log, State);
+					m_RolloutRandom.SetSeed (RoundSeed);
+
+					TryMove (m_VMoves [i], RoundSeed);
+					for (unsigned k (0); k < Horizon; ++k)
+					{
+						CMove Next;
+						if (!PickRolloutMove (Next)) break;
+						TryMove (Next, m_RolloutRandom.Next ());
+					}
+					VSums [i] += m_Game.TotalScore - State.TotalScore;
+
+					RestoreGameState (m_Game, m_Log, State);
+				}
+			}
+
+			Move = m_VMoves [max_element (VSums.begin (), VSums.end ()) - VSums.begin ()];
+			return true;
+		}
+
+	  public:
+		CMonteCarloPolicy (const unsigned long long& Seed, const unsigned& BudgetMs)
+			: CSearchPolicy (Seed, BudgetMs), m_RolloutRandom (Seed) {}
+
+	};// CMonteCarloPolicy
+
+	/**
+	* \fn CSearchPolicy* : NewSearchPolicy (const string& Name, const unsigned long long& Seed, const unsigned& BudgetMs)
+	* \brief function to create a search policy from its name : "greedy", "expectimax" or "montecarlo".
+	*
+	*\return NULL for any other name
+	*/
+	CSearchPolicy* NewSearchPolicy (const string& Name, const unsigned long long& Seed, const unsigned& BudgetMs)
+	{
+		if ("greedy" == Name)
+			return new CGreedyPolicy (Seed, BudgetMs);
+		if ("expectimax" == Name)
+			return new CExpectimaxPolicy (Seed, BudgetMs);
+		if ("montecarlo" == Name)
+			return new CMonteCarloPolicy (Seed, BudgetMs);
+
+		return NULL;
+
+	}// NewSearchPolicy ()
+
+					/**
+					* \fn bool : Test_SearchPolicyAllocations ()
+					* \brief test function @see SyncGame : on a CBitBoard, once the game is copied, choosing a move does not allocate.
+					*/
+					bool Test_SearchPolicyAllocations ()
+					{
+						CGameConfig Config = MakeTestConfig (10, 10, 6, 200, true);
+						Config.IsBitBoard = true;
+
+						unsigned NbErrors (0);
+						for (unsigned Test (0); Test < 4; ++Test)
+						{
+							CGame Game;
+							InitGame (Game, Config, Test);
+							CGreedyPolicy Policy (Test, 0);
+							for (unsigned Turn (0); 0 != Game.NbMovesLeft; ++Turn)
+							{
+								CPosition Pos;
+								char Direction;
+								const unsigned long long NbAllocations = AllocationCount ();
+								if (!Policy (Game, Pos, Direction)) break;
+								if (0 != Turn && AllocationCount () != NbAllocations) ++NbErrors;
+
+								PlayMove (Game, Pos, Direction);
+							}
+						}
+						return ReportTest ("Test_SearchPolicyAllocations", NbErrors);
+
+					}// Test_SearchPolicyAllocations ()
+
+	/** \struct CSolverEntry
+	 *
+	 * \brief an entry of the transposition table of CSolver, 16 bytes
+	 *
+	 */
+	struct CSolverEntry
+	{
+		unsigned long long	Key;		/*!< \brief Zobrist key of the matrix and of the state of the refills */
+		unsigned			Value;		/*!< \brief the points won in Depth moves, or more than the points when IsUpper */
+		unsigned short		Move;		/*!< \brief index of the best move in the list of the matching moves, KNoMove if none */
+		unsigned char		Depth;		/*!< \brief how many moves were searched, 0 for an empty entry */
+		bool				IsUpper;	/*!< \brief Value is only an upper bound : no sequence beat the score searched for */
+	};
+	typedef vector <CSolverEntry>		CVSolverEntry;/*!< \brief a type representing a transposition table */
+
+	/** \class CSolver
+	 *
+	 * \brief search of the best sequence of moves from a matrix, the refills being drawn from a known seed
+	 *
+	 * The state of a game is the matrix and the state of its generator : the same moves always
+	 * give the same refills. The depth grows one move at a time (iterative deepening); each depth
+	 * is a depth-first search of the moves making a sequence, played and undone with an undo log.
+	 * The states already searched are kept in a transposition table of fixed size, keyed by the
+	 * Zobrist key of the matrix, updated from the changes of the undo log, mixed with the state of
+	 * the generator. The key of a value of a cell is a hash of both, not read from a table sized
+	 * to the matrix. With a bound on the points of one move, a move is not searched further when
+	 * its points, plus the bound for each move left, can not beat the best score : the score found
+	 * is the best one as long as no move wins more than the bound. Without bound, every sequence
+	 * of moves making a sequence of numbers is searched.
+	 *
+	 */
+	class CSolver
+	{
+		CGame								m_Game;			/*!< \brief the game the moves are tried on */
+		CUndoLog							m_Log;			/*!< \brief changes of the cells of m_Game */
+		CVSolverEntry						m_VTable;		/*!< \brief the transposition table, a power of 2 entries */
+		CVUInt								m_VStamp;		/*!< \brief last key update which read each cell */
+		unsigned							m_Stamp;		/*!< \brief number of the current key update */
+		vector <CVMove>						m_VMovesByDepth;/*!< \brief the moves tried at each depth */
+		unsigned							m_GainBound;	/*!< \brief most points one move may win, 0 for no bound */
+		unsigned							m_MaxGain;		/*!< \brief best points won by one move so far */
+		unsigned long long					m_NbNodes;		/*!< \brief how many moves were played and undone */
+		unsigned long long					m_NbStored;		/*!< \brief how many entries were written in the table */
+		unsigned							m_BudgetMs;		/*!< \brief time of the search, 0 for no limit */
+		chrono::steady_clock::time_point	m_Deadline;		/*!< \brief end of the time of the search, from the construction */
+		bool								m_IsAborted;	/*!< \brief the time ran out during the current depth */
+
+		/**
+		* \fn unsigned long long : ZobristKey (const unsigned& Offset, const char& Cell)
+		* \brief function to get the Zobrist key of a value of a cell.
+		*/
+		static unsigned long long ZobristKey (const unsigned& Offset, const char& Cell)
+		{
+			unsigned long long State ((unsigned long long) (Offset) << 8 | (unsigned char) (Cell));
+			return SplitMix64 (State);
+		}
+
+		/**
+		* \fn unsigned long long : GetKey (const unsigned long long& GridKey) const
+		* \brief function to get the key of the state of m_Game from the key of its matrix.
+		*/
+		unsigned long long GetKey (const unsigned long long& GridKey) const
+		{
+			CRandom Random (m_Game.Random);
+			return GridKey ^ Random.Next ();
+		}
+
+		/**
+		* \fn unsigned long long : UpdateKey (unsigned long long GridKey, const unsigned& Mark)
+		* \brief function to get the key of the matrix after the changes recorded since Mark, from its key before them.
+		*
+		* The first change of a cell holds its value before the move : the key of this value is
+		* replaced with the key of the value the cell holds now, in O(changed cells).
+		*/
+		unsigned long long UpdateKey (unsigned long long GridKey, const unsigned& Mark)
+		{
+			++m_Stamp;
+			const char* Cells = m_Game.Grid.GetData ();
+			for (unsigned i (Mark); i < m_Log.GetCheckpoint (); ++i)
+			{
+				const unsigned Offset = m_Log [i].Offset;
+				if (m_Stamp == m_VStamp [Offset]) continue;
+
+				m_VStamp [Offset] = m_Stamp;
+				GridKey ^= ZobristKey (Offset, m_Log [i].Value) ^ ZobristKey (Offset, Cells [Offset]);
+			}
+
+			return GridKey;
+		}
+
+		/**
+		* \fn Store (const unsigned long long& Key, const unsigned& Depth, const unsigned& Value, const unsigned short& Move, const bool& IsUpper)
+		* \brief function to keep the result of a search, in place of an entry of another state searched less deep.
+		*/
+		void Store (const unsigned long long& Key, const unsigned& Depth, const unsigned& Value, const unsigned short& Move, const bool& IsUpper)
+		{
+			CSolverEntry& Entry = m_VTable [Key & (m_VTable.size () - 1)];
+			if (Entry.Key != Key && Entry.Depth > Depth) return;
+
+			if (0 == Entry.Depth) ++m_NbStored;
+			Entry.Key		= Key;
+			Entry.Value		= Value;
+			Entry.Move		= Move;
+			Entry.Depth		= (unsigned char) Depth;
+			Entry.IsUpper	= IsUpper;
+		}
+
+		/**
+		* \fn unsigned : Search (const unsigned& Depth, const unsigned long long& GridKey, const long long& Floor, unsigned short& BestMove)
+		* \brief function to get the best points won from m_Game in Depth moves, when they are more than Floor.
+		*
+		*\param Depth : how many moves are searched
+		*\param GridKey : Zobrist key of the matrix
+		*\param Floor : the points to beat, -1 to get the best points whatever they are
+		*\param BestMove : receives the index of the best move in the list of the matching moves, KNoMove if none
+		*\return the best points if they are more than Floor, else at most Floor
+		*/
+		unsigned Search (const unsigned& Depth, const unsigned long long& GridKey, const long long& Floor, unsigned short& BestMove)
+		{
+			BestMove = KNoMove;
+			if (0 == Depth || 0 == m_Game.NbMovesLeft) return 0;
+
+			const unsigned long long Key = GetKey (GridKey);
+			const CSolverEntry& Entry = m_VTable [Key & (m_VTable.size () - 1)];
+			const bool IsKnown = Entry.Key == Key && Entry.Depth == Depth;
+			if (IsKnown && (!Entry.IsUpper || (long long) (Entry.Value) <= Floor))
+			{
+				BestMove = Entry.Move;
+				return Entry.Value;
+			}
+			if (m_BudgetMs && chrono::steady_clock::now () >= m_Deadline)
+			{
+				m_IsAborted = true;
+				return 0;
+			}
+
+			CVMove& VMoves = m_VMovesByDepth [Depth];
+			m_Game.Rules->ListMatchingMoves (m_Game.Grid, VMoves);
+
+			//the best move of a previous search first
+			const unsigned First = (IsKnown && Entry.Move < VMoves.size ()) ? Entry.Move : 0;
+			unsigned Best (0);
+			for (unsigned k (0); k < VMoves.size () && !m_IsAborted; ++k)
+			{
+				const unsigned i = (0 == k) ? First : (k <= First ? k - 1 : k);
+				const long long Target = max (Floor, (long long) (Best));
+
+				CGameState State;
+				SaveGameState (m_Game, m_Log, State);
+				const unsigned Gain = ApplyMove (m_Game, VMoves [i], m_Log);
+				++m_NbNodes;
+				m_MaxGain = max (m_MaxGain, Gain);
+
+				unsigned Value (Gain);
+				if (Depth > 1 && (0 == m_GainBound || Gain + (long long) (Depth - 1) * m_GainBound > Target))
+				{
+					unsigned short ChildMove;
+					Value += Search (Depth - 1, UpdateKey (GridKey, State.Mark), Target - Gain, ChildMove);
+				}
+				RestoreGameState (m_Game, m_Log, State);
+
+				if (Value > Best || KNoMove == BestMove)
+				{
+					Best = max (Best, Value);
+					BestMove = (unsigned short) i;
+				}
+			}
+			if (m_IsAborted) return 0;
+
+			const bool IsUpper = (long long) (Best) <= Floor;
+			Store (Key, Depth, IsUpper ? unsigned (Floor) : Best, BestMove, IsUpper);
+			return IsUpper ? unsigned (Floor) : Best;
+		}
+
+	  public:
+		/**
+		* \fn CSolver (const CGame& Game, const unsigned& TableMb, const unsigned& BudgetMs, const unsigned& GainBound)
+		* \brief constructor of a search from a game, with a table of at most TableMb MB, BudgetMs ms and GainBound points per move, 0 for no limit.
+		*/
+		CSolver (const CGame& Game, const unsigned& TableMb, const unsigned& BudgetMs, const unsigned& GainBound)
+			: m_Game (Game), m_Stamp (0), m_VMovesByDepth (Game.NbMovesLeft + 1), m_GainBound (GainBound), m_MaxGain (0), m_NbNodes (0), m_NbStored (0), m_BudgetMs (BudgetMs), m_IsAborted (false)
+		{
+			m_VStamp.assign (Game.Grid.GetHeigth () * Game.Grid.GetWidth (), 0);
+
+			unsigned long long NbEntries (1);
+			for ( ; 2 * NbEntries * sizeof (CSolverEntry) <= (unsigned long long) (max (TableMb, 1u)) << 20; )
+				NbEntries *= 2;
+			const CSolverEntry Empty = { 0, 0, KNoMove, 0, false };
+			m_VTable.assign (NbEntries, Empty);
+			m_Deadline = chrono::steady_clock::now () + chrono::milliseconds (m_BudgetMs);
+		}
+
+		/**
+		* \fn unsigned long long : GetGridKey () const
+		* \brief function to get the Zobrist key of the matrix of the game.
+		*/
+		unsigned long long GetGridKey () const
+		{
+			unsigned long long GridKey (0);
+			const char* Cells = m_Game.Grid.GetData ();
+			for (unsigned Offset (0); Offset < m_VStamp.size (); ++Offset)
+				GridKey ^= ZobristKey (Offset, Cells [Offset]);
+
+			return GridKey;
+		}
+
+		/**
+		* \fn bool : SolveDepth (const unsigned& Depth, const unsigned& Previous, unsigned& Best, CVMove& VSequence)
+		* \brief function to find the best sequence of at most Depth moves, knowing the best points in Depth - 1 moves.
+		*
+		* The sequence is read again from the table, searching the states it lacks.
+		*
+		*\return false if the time ran out
+		*/
+		bool SolveDepth (const unsigned& Depth, const unsigned& Previous, unsigned& Best, CVMove& VSequence)
+		{
+			m_IsAborted = false;
+
+			//the best points can not be less than in Depth - 1 moves, unless a move wins more than the bound
+			const unsigned long long GridKey = GetGridKey ();
+			unsigned short Move;
+			Best = Search (Depth, GridKey, (long long) (Previous) - 1, Move);
+			if (Best < Previous && !m_IsAborted)
+				Best = Search (Depth, GridKey, -1, Move);
+			if (m_IsAborted) return false;
+
+			VSequence.clear ();
+			CGameState State;
+			SaveGameState (m_Game, m_Log, State);
+			unsigned long long Key (GridKey);
+			for (unsigned Left (Best), d (Depth); d > 0 && Left > 0 && !m_IsAborted; --d)
+			{
+				Search (d, Key, (long long) (Left) - 1, Move);
+				CVMove VMoves;
+				m_Game.Rules->ListMatchingMoves (m_Game.Grid, VMoves);
+				if (Move >= VMoves.size ()) break;
+
+				const unsigned Mark = m_Log.GetCheckpoint ();
+				Left -= min (Left, ApplyMove (m_Game, VMoves [Move], m_Log));
+				Key = UpdateKey (Key, Mark);
+				VSequence.push_back (VMoves [Move]);
+			}
+			RestoreGameState (m_Game, m_Log, State);
+
+			return !m_IsAborted;
+		}
+
+		unsigned long long	GetNbNodes	() const { return m_NbNodes; }
+		unsigned long long	GetNbStored	() const { return m_NbStored; }
+		unsigned			GetMaxGain	() const { return m_MaxGain; }
+		const CVSolverEntry& GetTable	() const { return m_VTable; }
+
+	};// CSolver
+
+	/**
+	* \fn bool : LoadBoard (const string& FileName, CBoard& Grid, unsigned& NbCandies)
+	* \brief function to read a matrix from a text file, one row per line, a cell being written as in Grid : '1' to '9', or a special cell.
+	*
+	*\param Grid : receives the matrix, with its border
+	*\param NbCandies : receives the largest number of the matrix, 3 at least
+	*\return false if the file can not be read, its rows are not of the same length or a cell is not valid
+	*/
+	bool LoadBoard (const string& FileName, CBoard& Grid, unsigned& NbCandies)
+	{
+		ifstream File (FileName.c_str ());
+		CVString VRows;
+		for (string Line; getline (File, Line); )
+		{
+			if (!Line.empty () && '\r' == Line [Line.size () - 1])
+				Line.erase (Line.size () - 1);
+			if (!Line.empty ())
+				VRows.push_back (Line);
+		}
+		if (VRows.size () < 3 || VRows [0].size () < 3 || VRows.size () > KMaxBoardSize || VRows [0].size () > KMaxBoardSize) return false;
+
+		InitGrid (Grid, VRows [0].size () + 2, VRows.size () + 2);
+		NbCandies = 3;
+		for (unsigned i (0); i < VRows.size (); ++i)
+		{
+			if (VRows [i].size () != VRows [0].size ()) return false;
+
+			for (unsigned j (0); j < VRows [i].size (); ++j)
+			{
+				const char Cell = VRows [i][j];
+				if (Cell <= KImpossible || !IsBetween <unsigned> (CellColor (Cell), 1, 9) || CellKind (Cell) > KSpecialColor)
+					return false;
+
+				Grid [i + 1][j + 1] = Cell;
+				NbCandies = max (NbCandies, unsigned (CellColor (Cell)));
+			}
+		}
+
+		return true;
+
+	}// LoadBoard ()
+
+	/**
+	* \fn InitSolverGame (CGame& Game, CGameConfig& Config, const CBoard& Grid, const unsigned& NbCandies, const unsigned long long& Seed)
+	* \brief function to start a game on a given matrix, its refills being drawn from Seed.
+	*
+	*\param Config : the settings, whose size and number of candies are set to the ones of the matrix
+	*/
+	void InitSolverGame (CGame& Game, CGameConfig& Config, const CBoard& Grid, const unsigned& NbCandies, const unsigned long long& Seed)
+	{
+		Config.MatHeigth	= Grid.GetHeigth () - 2;
+		Config.MatWidth		= Grid.GetWidth () - 2;
+		Config.NbCandies	= NbCandies;
+		InitGame (Game, Config, Seed);
+
+		Game.Grid = Grid;
+		Game.Random.SetSeed (Seed);
+		if (Game.IsBitBoard)
+			Game.Bits.FromBoard (Game.Grid, NbCandies);
+
+	}// InitSolverGame ()
+
+					/**
+					* \fn unsigned : BruteForce (CGame& Game, CUndoLog& Log, const unsigned& Depth, unsigned& MaxGain)
+					* \brief function to get the best points in Depth moves making a sequence, trying them all, @see Test_Solver.
+					*
+					*\param MaxGain : receives the most points won by one of the moves tried, if more
+					*/
+					unsigned BruteForce (CGame& Game, CUndoLog& Log, const unsigned& Depth, unsigned& MaxGain)
+					{
+						if (0 == Depth) return 0;
+
+						CVMove VMoves;
+						Game.Rules->ListMatchingMoves (Game.Grid, VMoves);
+						unsigned Best (0);
+						for (unsigned i (0); i < VMoves.size (); ++i)
+						{
+							CGameState State;
+							SaveGameState (Game, Log, State);
+							const unsigned Gain = ApplyMove (Game, VMoves [i], Log);
+							MaxGain = max (MaxGain, Gain);
+							Best = max (Best, Gain + BruteForce (Game, Log, Depth - 1, MaxGain));
+							RestoreGameState (Game, Log, State);
+						}
+
+						return Best;
+
+					}// BruteForce ()
+
+					/**
+					* \fn bool : Test_Solver ()
+					* \brief test function @see CSolver : the score found is the one of BruteForce, and its sequence wins it,
+					* without bound and with the exact bound of the points of a move.
+					*/
+					bool Test_Solver ()
+					{
+						unsigned NbErrors (0);
+						for (unsigned Test (0); Test < 20; ++Test)
+						{
+							CGameConfig Config = MakeTestConfig (5 + Test % 3, 5 + Test % 4, 4 + Test % 3, 3, 0 != Test % 2);
+
+							CGame Game;
+							InitGame (Game, Config, Test);
+							CUndoLog Log;
+							unsigned MaxGain (0);
+							const unsigned Expected = BruteForce (Game, Log, Config.NbMaxTimes, MaxGain);
+
+							for (unsigned GainBound (0); GainBound <= MaxGain; GainBound += MaxGain)
+							{
+								//a small table : the entries are replaced
+								CSolver Solver (Game, 0, 0, GainBound);
+								unsigned Best (0);
+								CVMove VSequence;
+								for (unsigned Depth (1); Depth <= Config.NbMaxTimes; ++Depth)
+									Solver.SolveDepth (Depth, Best, Best, VSequence);
+								if (Best != Expected) ++NbErrors;
+
+								CGame Played (Game);
+								for (unsigned i (0); i < VSequence.size (); ++i)
+									ApplyMove (Played, VSequence [i], Log);
+								if (Played.TotalScore != Best) ++NbErrors;
+								if (0 == MaxGain) break;
+							}
+						}
+						return ReportTest ("Test_Solver", NbErrors);
+
+					}// Test_Solver ()
+
+	/**
+	* \fn bool : Solve (CGameConfig Config, const string& FileName, const unsigned long long& Seed, const unsigned& TableMb, const unsigned& BudgetMs, const unsigned& GainBound)
+	* \brief function to find the best sequence of Config.NbMaxTimes moves from the matrix of a file, and show it with the cost of the search.
+	*
+	*\param Config : the settings, giving the number of moves, the bitboards and the special cells
+	*\param FileName : the matrix, @see LoadBoard
+	*\param Seed : seed of the refills
+	*\param TableMb : size of the transposition table, in MB
+	*\param BudgetMs : time of the search, 0 for no limit : the best sequence of the last depth searched is shown
+	*\param GainBound : most points one move may win, 0 for no bound, @see CSolver
+	*\return false if the file can not be read
+	*/
+	bool Solve (CGameConfig Config, const string& FileName, const unsigned long long& Seed, const unsigned& TableMb, const unsigned& BudgetMs, const unsigned& GainBound)
+	{
+		CBoard Grid;
+		unsigned NbCandies;
+		if (!LoadBoard (FileName, Grid, NbCandies))
+		{
+			cerr << "Fichier de grille invalide '" << FileName << "'" << endl;
+			return false;
+		}
+
+		CGame Game;
+		InitSolverGame (Game, Config, Grid, NbCandies, Seed);
+		CSolver Solver (Game, TableMb, BudgetMs, GainBound);
+
+		const chrono::steady_clock::time_point Begin = chrono::steady_clock::now ();
+		unsigned Best (0), Depth (0);
+		CVMove VSequence;
+		for (unsigned d (1); d <= Config.NbMaxTimes; ++d)
+		{
+			unsigned DepthBest;
+			CVMove VDepthSequence;
+			if (!Solver.SolveDepth (d, Best, DepthBest, VDepthSequence)) break;
+
+			Best		= DepthBest;
+			Depth		= d;
+			VSequence	= VDepthSequence;
+			cout << "Profondeur " << setw (4) << left << d << right << ": " << Best << " points, "
+				 << Solver.GetNbNodes () << " noeuds" << endl;
+		}
+		const double Seconds = chrono::duration <double> (chrono::steady_clock::now () - Begin).count ();
+
+		rusage Usage;
+		getrusage (RUSAGE_SELF, &Usage);
+		const double TableMbUsed = double (Solver.GetTable ().size () * sizeof (CSolverEntry)) / (1 << 20);
+
+		cout << "Graine            : " << Seed << endl;
+		cout << "Grille            : " << Config.MatHeigth << "x" << Config.MatWidth << ", " << NbCandies << " nombres" << endl;
+		cout << "Profondeur        : " << Depth << " / " << Config.NbMaxTimes << " coups" << endl;
+		cout << "Meilleur score    : " << Best << endl;
+		cout << "Coups             :";
+		for (unsigned i (0); i < VSequence.size (); ++i)
+			cout << (i ? ", " : " ") << VSequence [i].Pos.first << ' ' << VSequence [i].Pos.second << ' ' << VSequence [i].Direction;
+		cout << endl;
+		cout << "Gain maximal      : " << Solver.GetMaxGain () << " points" << endl;
+		if (0 != GainBound)
+			cout << "Elagage           : " << GainBound << " points par coup au plus"
+				 << (Solver.GetMaxGain () > GainBound ? ", depasse : le score n'est pas garanti" : "") << endl;
+		cout << "Duree (s)         : " << Seconds << endl;
+		cout << "Noeuds explores   : " << Solver.GetNbNodes () << endl;
+		cout << "Noeuds par seconde: " << (Seconds > 0 ? Solver.GetNbNodes () / Seconds : 0) << endl;
+		cout << "Table (Mo)        : " << TableMbUsed << ", " << Solver.GetNbStored () << " / " << Solver.GetTable ().size () << " entrees" << endl;
+		cout << "Memoire (Mo)      : " << Usage.ru_maxrss / 1024.0 << endl;
+
+		return true;
+
+	}// Solve ()
+
+	/**
+	* \fn MergeStats (CStats& Total, const CStats& ThreadStats)
+	* \brief function to add the counters of a thread to a total.
+	*/
+	void MergeStats (CStats& Total, const CStats& ThreadStats)
+	{
+		for (unsigned k (0); k < KNbPhases; ++k)
+		{
+			Total.VNbCalls [k]	+= ThreadStats.VNbCalls [k];
+			Total.VNs [k]		+= ThreadStats.VNs [k];
+		}
+		Total.NbTurns		+= ThreadStats.NbTurns;
+		Total.SumDepth		+= ThreadStats.SumDepth;
+		Total.MaxDepth		 = max (Total.MaxDepth, ThreadStats.MaxDepth);
+		Total.SumMatches	+= ThreadStats.SumMatches;
+		Total.MaxMatches	 = max (Total.MaxMatches, ThreadStats.MaxMatches);
+		Total.NbRandomDraws	+= ThreadStats.NbRandomDraws;
+
+	}// MergeStats ()
+
+	/**
+	* \fn bool : ReportStats (const CStats& Total, const string& FileName)
+	* \brief function to show the counters of the instrumentation, and write them in a JSON file.
+	*
+	*\param Total : the counters
+	*\param FileName : the name of the JSON file
+	*\return false if the program was compiled without NUMBERCRUSH_STATS or the file can not be written
+	*/
+	bool ReportStats (const CStats& Total, const string& FileName)
+	{
+#ifndef NUMBERCRUSH_STATS
+		cerr << "Statistiques indisponibles : compiler avec -DNUMBERCRUSH_STATS" << endl;
+		return false;
+#else
+		const double NbTurns = Total.NbTurns ? Total.NbTurns : 1;
+
+		cout << setw (16) << left << "Phase" << right << setw (12) << "Appels"
+			 << setw (14) << "Temps (ms)" << setw (12) << "ns/appel" << endl;
+		for (unsigned k (0); k < KNbPhases; ++k)
+			cout << setw (16) << left << KPhaseNames [k] << right << setw (12) << Total.VNbCalls [k]
+				 << setw (14) << Total.VNs [k] / 1e6
+				 << setw (12) << (Total.VNbCalls [k] ? Total.VNs [k] / Total.VNbCalls [k] : 0) << endl;
+		cout << "Coups joues            : " << Total.NbTurns << endl;
+		cout << "Cascade moyenne / max  : " << Total.SumDepth / NbTurns << " / " << Total.MaxDepth << endl;
+		cout << "Suites par coup / max  : " << Total.SumMatches / NbTurns << " / " << Total.MaxMatches << endl;
+		cout << "Tirages aleatoires     : " << Total.NbRandomDraws << endl;
+
+		ofstream File (FileName.c_str (), ios_base::out | ios_base::trunc);
+		File << "{" << endl
+			 << "  \"phases\": [" << endl;
+		for (unsigned k (0); k < KNbPhases; ++k)
+			File << "    {\"phase\": \"" << KPhaseNames [k] << "\""
+				 << ", \"calls\": " << Total.VNbCalls [k]
+				 << ", \"ns\": " << Total.VNs [k]
+				 << "}" << (k + 1 < KNbPhases ? "," : "") << endl;
+		File << "  ]," << endl
+			 << "  \"turns\": " << Total.NbTurns << "," << endl
+			 << "  \"cascade_depth\": {\"mean\": " << Total.SumDepth / NbTurns << ", \"max\": " << Total.MaxDepth << "}," << endl
+			 << "  \"matches_per_turn\": {\"mean\": " << Total.SumMatches / NbTurns << ", \"max\": " << Total.MaxMatches << "}," << endl
+			 << "  \"random_draws\": " << Total.NbRandomDraws << endl
+			 << "}" << endl;
+
+		return bool (File);
+#endif
+
+	}// ReportStats ()
+
+	/**
+	* \fn AppendLE (string& Buffer, const unsigned long long& Value, const unsigned& NbBytes)
+	* \brief function to write the NbBytes low bytes of a number at the end of a buffer, least significant first.
+	*/
+	void AppendLE (string& Buffer, const unsigned long long& Value, const unsigned& NbBytes)
+	{
+		for (unsigned i (0); i < NbBytes; ++i)
+			Buffer += char ((Value >> (8 * i)) & 0xFF);
+
+	}// AppendLE ()
+
+	/**
+	* \fn bool : ReadLE (const string& Buffer, unsigned& Offset, const unsigned& NbBytes, unsigned long long& Value)
+	* \brief function to read a number of NbBytes bytes, least significant first, false if the buffer is too short.
+	*/
+	bool ReadLE (const string& Buffer, unsigned& Offset, const unsigned& NbBytes, unsigned long long& Value)
+	{
+		if (Buffer.size () < Offset + NbBytes) return false;
+
+		Value = 0;
+		for (unsigned i (0); i < NbBytes; ++i)
+			Value |= (unsigned long long) (unsigned char) Buffer [Offset + i] << (8 * i);
+		Offset += NbBytes;
+
+		return true;
+
+	}// ReadLE ()
+
+	/**
+	* \fn unsigned long long : ScoreConfigKey (const CGameConfig& Config)
+	* \brief function to get a number identifying the settings of a game, a leaderboard holding the games of the same settings.
+	*/
+	inline unsigned long long ScoreConfigKey (const CGameConfig& Config)
+	{
+		return (unsigned long long) Config.MatHeigth		 | (unsigned long long) Config.MatWidth << 16
+			 | (unsigned long long) Config.NbCandies << 32 | (unsigned long long) Config.IsSpecials << 40
+			 | (unsigned long long) Config.NbMaxTimes << 48;
+
+	}// ScoreConfigKey ()
+
+	/**
+	* \fn AppendScoreRecord (string& Buffer, const CScoreRecord& Record)
+	* \brief function to write a record of the log of the scores at the end of a buffer.
+	*
+	* A record is KScoreRecordSize bytes : the name of the player padded with 0 to KScoreNameSize bytes,
+	* the seed and the date on 8 bytes, the rows and the columns on 2 bytes, the numbers and the flag of
+	* the special cells on 1 byte, the moves of the game on 2 bytes, the score and the moves played on
+	* 4 bytes, all least significant byte first.
+	*/
+	void AppendScoreRecord (string& Buffer, const CScoreRecord& Record)
+	{
+		const unsigned NameSize = min <unsigned> (Record.Player.size (), KScoreNameSize);
+		Buffer.append (Record.Player, 0, NameSize);
+		Buffer.append (KScoreNameSize - NameSize, '\0');
+		AppendLE (Buffer, Record.Seed, 8);
+		AppendLE (Buffer, Record.Date, 8);
+		AppendLE (Buffer, Record.Config.MatHeigth, 2);
+		AppendLE (Buffer, Record.Config.MatWidth, 2);
+		AppendLE (Buffer, Record.Config.NbCandies, 1);
+		AppendLE (Buffer, Record.Config.IsSpecials, 1);
+		AppendLE (Buffer, Record.Config.NbMaxTimes, 2);
+		AppendLE (Buffer, Record.TotalScore, 4);
+		AppendLE (Buffer, Record.NbMoves, 4);
+
+	}// AppendScoreRecord ()
+
+	/**
+	* \fn ReadScoreRecord (const string& Buffer, unsigned Offset, CScoreRecord& Record)
+	* \brief function to read a record of the log of the scores, @see AppendScoreRecord.
+	*
+	*\param Offset : first byte of the record in Buffer, which holds it whole
+	*/
+	void ReadScoreRecord (const string& Buffer, unsigned Offset, CScoreRecord& Record)
+	{
+		const char* Name = Buffer.data () + Offset;
+		Record.Player.assign (Name, find (Name, Name + KScoreNameSize, '\0'));
+		Offset += KScoreNameSize;
+
+		unsigned long long Heigth (0), Width (0), NbCandies (0), IsSpecials (0), NbMaxTimes (0), TotalScore (0), NbMoves (0);
+		ReadLE (Buffer, Offset, 8, Record.Seed);
+		ReadLE (Buffer, Offset, 8, Record.Date);
+		ReadLE (Buffer, Offset, 2, Heigth);
+		ReadLE (Buffer, Offset, 2, Width);
+		ReadLE (Buffer, Offset, 1, NbCandies);
+		ReadLE (Buffer, Offset, 1, IsSpecials);
+		ReadLE (Buffer, Offset, 2, NbMaxTimes);
+		ReadLE (Buffer, Offset, 4, TotalScore);
+		ReadLE (Buffer, Offset, 4, NbMoves);
+		Record.Config.MatHeigth		= Heigth;
+		Record.Config.MatWidth		= Width;
+		Record.Config.NbCandies		= NbCandies;
+		Record.Config.IsSpecials	= 0 != IsSpecials;
+		Record.Config.IsBitBoard	= false;
+		Record.Config.NbMaxTimes	= NbMaxTimes;
+		Record.TotalScore			= TotalScore;
+		Record.NbMoves				= NbMoves;
+
+	}// ReadScoreRecord ()
+
+	/**
+	* \fn bool : IsBetterScore (const CScoreEntry& First, const CScoreEntry& Second)
+	* \brief function to order the entries by score, the best first, then by age, the oldest first.
+	*/
+	inline bool IsBetterScore (const CScoreEntry& First, const CScoreEntry& Second)
+	{
+		return First.Score != Second.Score ? First.Score > Second.Score : First.Record < Second.Record;
+
+	}// IsBetterScore ()
+
+	/**
+	* \fn bool : IsBetterInConfig (const CScoreEntry& First, const CScoreEntry& Second)
+	* \brief function to order the entries by settings, then as IsBetterScore.
+	*/
+	inline bool IsBetterInConfig (const CScoreEntry& First, const CScoreEntry& Second)
+	{
+		return First.Config != Second.Config ? First.Config < Second.Config : IsBetterScore (First, Second);
+
+	}// IsBetterInConfig ()
+
+	/** \class CScoreStore
+	 *
+	 * \brief the results of every game : an append-only log and its sorted index, mapped in memory
+	 *
+	 * The log holds KScoreMagic then one record per game, @see AppendScoreRecord. The index holds the
+	 * entries of the first records of the log twice, sorted by IsBetterInConfig then by IsBetterScore :
+	 * the best scores of all settings or of some settings are found by a binary search and read from
+	 * the log. The records appended after the index are read by each query, until Compact merges them
+	 * in the index ; Append does it once there are more than KScoreTailSize of them.
+	 * Opening the store only maps the index : the log is not read.
+	 *
+	 */
+	class CScoreStore
+	{
+		string				m_LogName;		/*!< \brief name of the log */
+		string				m_IndexName;	/*!< \brief name of the index */
+		void*				m_Map;			/*!< \brief the index mapped in memory, NULL when there is none */
+		size_t				m_MapSize;		/*!< \brief bytes of the index */
+		const CScoreEntry*	m_VByConfig;	/*!< \brief the entries sorted by IsBetterInConfig, NULL when there is no index */
+		const CScoreEntry*	m_VByScore;		/*!< \brief the entries sorted by IsBetterScore, NULL when there is no index */
+		unsigned			m_NbIndexed;	/*!< \brief the first records of the log in the index */
+
+		/**
+		* \fn Map ()
+		* \brief function to map the index in memory, an index not matching the log being ignored.
+		*/
+		void Map ()
+		{
+			m_Map		= NULL;
+			m_MapSize	= 0;
+			m_VByConfig	= NULL;
+			m_VByScore	= NULL;
+			m_NbIndexed	= 0;
+
+			const int File = open (m_IndexName.c_str (), O_RDONLY);
+			if (File < 0) return;
+
+			struct stat Status;
+			if (0 == fstat (File, &Status) && sizeof (CScoreIndexHeader) <= size_t (Status.st_size))
+			{
+				m_MapSize	= Status.st_size;
+				m_Map		= mmap (NULL, m_MapSize, PROT_READ, MAP_SHARED, File, 0);
+				if (MAP_FAILED == m_Map) m_Map = NULL;
+			}
+			close (File);
+			if (!m_Map) return;
+
+			const CScoreIndexHeader& Header = *(const CScoreIndexHeader*) m_Map;
+			if (KScoreIndexMagic != Header.Magic || sizeof (CScoreEntry) != Header.EntrySize
+			 || m_MapSize != sizeof (CScoreIndexHeader) + 2 * sizeof (CScoreEntry) * Header.NbEntries
+			 || GetNbRecords () < Header.NbEntries)
+			{
+				Unmap ();
+				return;
+			}
+			m_VByConfig	= (const CScoreEntry*) ((const char*) m_Map + sizeof (CScoreIndexHeader));
+			m_VByScore	= m_VByConfig + Header.NbEntries;
+			m_NbIndexed	= Header.NbEntries;
+
+		}// Map ()
+
+		/**
+		* \fn Unmap ()
+		* \brief function to release the index mapped in memory.
+		*/
+		void Unmap ()
+		{
+			if (m_Map) munmap (m_Map, m_MapSize);
+			m_Map		= NULL;
+			m_MapSize	= 0;
+			m_VByConfig	= NULL;
+			m_VByScore	= NULL;
+			m_NbIndexed	= 0;
+
+		}// Unmap ()
+
+		/**
+		* \fn bool : ReadRecords (ifstream& File, const unsigned& First, const unsigned& NbRecords, string& Buffer) const
+		* \brief function to read consecutive records of the log, false if it does not hold them.
+		*/
+		bool ReadRecords (ifstream& File, const unsigned& First, const unsigned& NbRecords, string& Buffer) const
+		{
+			File.seekg (KScoreMagic.size () + (unsigned long long) First * KScoreRecordSize);
+			Buffer.resize ((size_t) NbRecords * KScoreRecordSize);
+			File.read (&Buffer [0], Buffer.size ());
+
+			return bool (File);
+
+		}// ReadRecords ()
+
+		/**
+		* \fn ReadTail (CVScoreEntry& VEntries) const
+		* \brief function to get the entries of the records appended after the index.
+		*/
+		void ReadTail (CVScoreEntry& VEntries) const
+		{
+			const unsigned NbRecords = GetNbRecords ();
+			VEntries.clear ();
+			if (NbRecords == m_NbIndexed) return;
+
+			ifstream File (m_LogName.c_str (), ios_base::in | ios_base::binary);
+			string Buffer;
+			if (!ReadRecords (File, m_NbIndexed, NbRecords - m_NbIndexed, Buffer)) return;
+
+			CScoreRecord Record;
+			VEntries.resize (NbRecords - m_NbIndexed);
+			for (unsigned i (0); i < VEntries.size (); ++i)
+			{
+				ReadScoreRecord (Buffer, i * KScoreRecordSize, Record);
+				VEntries [i].Config	= ScoreConfigKey (Record.Config);
+				VEntries [i].Score	= Record.TotalScore;
+				VEntries [i].Record	= m_NbIndexed + i;
+			}
+
+		}// ReadTail ()
+
+	  public:
+		/**
+		* \fn CScoreStore (const string& LogName = KScoreLogName, const string& IndexName = KScoreIndexName)
+		* \brief constructor mapping the index, the files being created by the first Append.
+		*/
+		explicit CScoreStore (const string& LogName = KScoreLogName, const string& IndexName = KScoreIndexName)
+			: m_LogName (LogName), m_IndexName (IndexName)
+		{
+			Map ();
+		}
+
+		~CScoreStore () { Unmap (); }
+
+		CScoreStore (const CScoreStore&) = delete;
+		CScoreStore& operator = (const CScoreStore&) = delete;
+
+		/**
+		* \fn unsigned : GetNbRecords () const
+		* \brief function to get the number of records of the log, an unfinished last one excluded.
+		*/
+		unsigned GetNbRecords () const
+		{
+			struct stat Status;
+			if (0 != stat (m_LogName.c_str (), &Status) || size_t (Status.st_size) < KScoreMagic.size ()) return 0;
+
+			return (Status.st_size - KScoreMagic.size ()) / KScoreRecordSize;
+
+		}// GetNbRecords ()
+
+		/**
+		* \fn bool : Append (const CVScoreRecord& VRecords)
+		* \brief function to add results at the end of the log in one write, then to compact it if needed.
+		*/
+		bool Append (const CVScoreRecord& VRecords)
+		{
+			if (VRecords.empty ()) return true;
+
+			struct stat Status;
+			string Buffer;
+			Buffer.reserve (KScoreMagic.size () + VRecords.size () * KScoreRecordSize);
+			if (0 != stat (m_LogName.c_str (), &Status) || 0 == Status.st_size)
+				Buffer = KScoreMagic;
+			for (unsigned i (0); i < VRecords.size (); ++i)
+				AppendScoreRecord (Buffer, VRecords [i]);
+
+			ofstream File (m_LogName.c_str (), ios_base::out | ios_base::binary | ios_base::app);
+			File.write (Buffer.data (), Buffer.size ());
+			File.close ();
+			if (!File) return false;
+
+			return GetNbRecords () - m_NbIndexed <= KScoreTailSize || Compact ();
+
+		}// Append ()
+
+		/**
+		* \fn bool : Compact ()
+		* \brief function to merge the records appended after the index in it, linear in the records.
+		*
+		* The new index is written beside the old one, then renamed over it : a reader keeps the one it mapped.
+		*/
+		bool Compact ()
+		{
+			CVScoreEntry VTail;
+			ReadTail (VTail);
+			if (VTail.empty ()) return true;
+
+			const unsigned NbEntries = m_NbIndexed + VTail.size ();
+			CVScoreEntry VEntries;
+			VEntries.reserve (2 * NbEntries);
+			sort (VTail.begin (), VTail.end (), IsBetterInConfig);
+			merge (m_VByConfig, m_VByConfig + m_NbIndexed, VTail.begin (), VTail.end (), back_inserter (VEntries), IsBetterInConfig);
+			sort (VTail.begin (), VTail.end (), IsBetterScore);
+			merge (m_VByScore, m_VByScore + m_NbIndexed, VTail.begin (), VTail.end (), back_inserter (VEntries), IsBetterScore);
+
+			CScoreIndexHeader Header;
+			Header.Magic		= KScoreIndexMagic;
+			Header.NbEntries	= NbEntries;
+			Header.EntrySize	= sizeof (CScoreEntry);
+			const string TempName (m_IndexName + ".tmp");
+			{
+				ofstream File (TempName.c_str (), ios_base::out | ios_base::binary | ios_base::trunc);
+				File.write ((const char*) &Header, sizeof (Header));
+				File.write ((const char*) VEntries.data (), VEntries.size () * sizeof (CScoreEntry));
+				if (!File) return false;
+			}
+			if (0 != rename (TempName.c_str (), m_IndexName.c_str ())) return false;
+
+			Unmap ();
+			Map ();
+
+			return NbEntries == m_NbIndexed;
+
+		}// Compact ()
+
+		/**
+		* \fn bool : GetBest (const unsigned& NbBest, CVScoreRecord& VBest, const CGameConfig* Config = NULL) const
+		* \brief function to get the best results, of every settings or of some settings, the best first.
+		*
+		*\param NbBest : how many results at most
+		*\param VBest : the results
+		*\param Config : the settings of the results, NULL for every settings
+		*\return false if the log can not be read
+		*/
+		bool GetBest (const unsigned& NbBest, CVScoreRecord& VBest, const CGameConfig* Config = NULL) const
+		{
+			CVScoreEntry VEntries;
+			ReadTail (VEntries);
+
+			const CScoreEntry* Begin = m_VByScore;
+			const CScoreEntry* End	 = m_VByScore + m_NbIndexed;
+			if (Config)
+			{
+				CScoreEntry Key;
+				Key.Config	= ScoreConfigKey (*Config);
+				Key.Score	= numeric_limits <unsigned>::max ();
+				Key.Record	= 0;
+				VEntries.erase (remove_if (VEntries.begin (), VEntries.end (),
+							    [&Key] (const CScoreEntry& Entry) { return Entry.Config != Key.Config; }), VEntries.end ());
+				Begin = lower_bound (m_VByConfig, m_VByConfig + m_NbIndexed, Key, IsBetterInConfig);
+				for (End = Begin; End != m_VByConfig + m_NbIndexed && End->Config == Key.Config && unsigned (End - Begin) < NbBest; ++End) ;
+			}
+			VEntries.insert (VEntries.end (), Begin, Begin + min <size_t> (NbBest, End - Begin));
+
+			const unsigned NbFound = min <size_t> (NbBest, VEntries.size ());
+			partial_sort (VEntries.begin (), VEntries.begin () + NbFound, VEntries.end (), IsBetterScore);
+			VBest.resize (NbFound);
+
+			ifstream File (m_LogName.c_str (), ios_base::in | ios_base::binary);
+			string Buffer;
+			for (unsigned i (0); i < NbFound; ++i)
+			{
+				if (!ReadRecords (File, VEntries [i].Record, 1, Buffer)) return false;
+				ReadScoreRecord (Buffer, 0, VBest [i]);
+			}
+
+			return true;
+
+		}// GetBest ()
+
+	};// CScoreStore
+
+					/**
+					* \fn bool : Test_ScoreStore ()
+					* \brief test function @see CScoreStore : the best results, with and without index, against a sort of every result.
+					*/
+					bool Test_ScoreStore ()
+					{
+						const string LogName ("test-scores.log"), IndexName ("test-scores.idx");
+						remove (LogName.c_str ());
+						remove (IndexName.c_str ());
+
+						CRandom Random (5);
+						CVScoreRecord VAll;
+						unsigned NbErrors (0);
+						for (unsigned Batch (0); Batch < 4; ++Batch)
+						{
+							CVScoreRecord VRecords (500);
+							for (unsigned i (0); i < VRecords.size (); ++i)
+							{
+								CScoreRecord& Record = VRecords [i];
+								Record.Player				= (i % 7) ? "joueur" : "un nom bien trop long";
+								Record.Config.MatHeigth		= 8 + Random.Next (3);
+								Record.Config.MatWidth		= 10;
+								Record.Config.NbCandies		= 5;
+								Record.Config.NbMaxTimes	= 20;
+								Record.Config.IsSpecials	= Random.Next (2);
+								Record.Config.IsBitBoard	= false;
+								Record.TotalScore			= Random.Next (1000);
+								Record.NbMoves				= 20;
+								Record.Seed					= Batch * 1000 + i;
+								Record.Date					= 0;
+							}
+							VAll.insert (VAll.end (), VRecords.begin (), VRecords.end ());
+
+							CScoreStore Store (LogName, IndexName);
+							if (!Store.Append (VRecords) || VAll.size () != Store.GetNbRecords ()) ++NbErrors;
+							if (1 == Batch % 2 && !Store.Compact ()) ++NbErrors;
+
+							//the expected results : the best score, then the oldest record
+							CVScoreRecord VExpected (VAll);
+							stable_sort (VExpected.begin (), VExpected.end (),
+										 [] (const CScoreRecord& First, const CScoreRecord& Second) { return First.TotalScore > Second.TotalScore; });
+							CVScoreRecord VBest;
+							Store.GetBest (25, VBest);
+							for (unsigned i (0); i < 25; ++i)
+								if (VBest.size () != 25 || VBest [i].Seed != VExpected [i].Seed || VBest [i].Player.size () > KScoreNameSize) ++NbErrors;
+
+							const CGameConfig& Config = VAll [Batch].Config;
+							VExpected.erase (remove_if (VExpected.begin (), VExpected.end (), [&Config] (const CScoreRecord& Record)
+											 { return ScoreConfigKey (Record.Config) != ScoreConfigKey (Config); }), VExpected.end ());
+							Store.GetBest (25, VBest, &Config);
+							for (unsigned i (0); i < 25; ++i)
+								if (VBest.size () != 25 || VBest [i].Seed != VExpected [i].Seed
+								 || ScoreConfigKey (VBest [i].Config) != ScoreConfigKey (Config)) ++NbErrors;
+						}
+						remove (LogName.c_str ());
+						remove (IndexName.c_str ());
+						return ReportTest ("Test_ScoreStore", NbErrors);
+
+					}// Test_ScoreStore ()
+
+	/**
+	* \fn ShowScores (const CVScoreRecord& VBest)
+	* \brief function to display a leaderboard.
+	*/
+	void ShowScores (const CVScoreRecord& VBest)
+	{
+		if (VBest.empty ())
+		{
+			cout << "Aucun score enregistre" << endl;
+			return;
+		}
+
+		cout << "Rang  Joueur            Score    Coups  Grille     Graine" << endl;
+		for (unsigned i (0); i < VBest.size (); ++i)
+		{
+			const CScoreRecord& Record = VBest [i];
+			ostringstream Grid;
+			Grid << Record.Config.MatHeigth << "x" << Record.Config.MatWidth << "/" << Record.Config.NbCandies
+				 << (Record.Config.IsSpecials ? "+" : "");
+			cout << setw (4) << left << i + 1 << "  " << setw (16) << Record.Player << "  " << setw (7) << right << Record.TotalScore
+				 << "  " << setw (5) << Record.NbMoves << "  " << setw (9) << left << Grid.str () << right << "  " << Record.Seed << endl;
+		}
+
+	}// ShowScores ()
+
+	/**
+	* \fn bool : ShowBestScores (const unsigned& NbBest, const CGameConfig* Config = NULL)
+	* \brief function to display the best results of the store, of every settings or of some settings.
+	*/
+	bool ShowBestScores (const unsigned& NbBest, const CGameConfig* Config = NULL)
+	{
+		CScoreStore Store;
+		CVScoreRecord VBest;
+		if (!Store.GetBest (NbBest, VBest, Config))
+		{
+			cerr << "Erreur de lecture du fichier '" << KScoreLogName << "'" << endl;
+			return false;
+		}
+		ShowScores (VBest);
+
+		return true;
+
+	}// ShowBestScores ()
+
+	/**
+	* \fn Simulate (const CGameConfig& Config, const unsigned& NbGames, const unsigned long long& Seed, const unsigned& NbThreads, const string& PolicyName, const unsigned& BudgetMs, const string& StatsName, const bool& IsSaveScores)
+	* \brief function to play games with a move policy, without display, and show score statistics.
+	*
+	* The game number i only depends on DeriveSeed (Seed, i) : the results are the same
+	* whatever the number of threads.
+	*
+	*\param Config : settings of the games
+	*\param NbGames : how many games to play
+	*\param Seed : master seed
+	*\param NbThreads : how many threads, 0 for one per core
+	*\param PolicyName : "random" or the name of a search policy, @see NewSearchPolicy
+	*\param BudgetMs : time of a search policy to choose a move, 0 for no limit
+	*\param StatsName : the JSON file receiving the counters of the instrumentation, none if empty
+	*\param IsSaveScores : the results are appended to the store of the scores, the policy being the player
+	*/
+	void Simulate (const CGameConfig& Config, const unsigned& NbGames, const unsigned long long& Seed,
+				   const unsigned& NbThreads, const string& PolicyName, const unsigned& BudgetMs, const string& StatsName,
+				   const bool& IsSaveScores)
+	{
+		CVUInt VScores (NbGames), VNbMoves (NbGames);
+		vector <CSearchStats> VStats (NbGames);
+		CStats TotalStats = CStats ();
+		mutex StatsMutex;
+
+		const chrono::steady_clock::time_point Begin = chrono::steady_clock::now ();
+		ParallelFor (NbGames, NbThreads, [&] (const unsigned i)
+		{
+			const unsigned long long GameSeed = DeriveSeed (Seed, i);
+			if (!StatsName.empty ()) Stats () = CStats ();
+
+			CGame Game;
+			InitGame (Game, Config, GameSeed);
+
+			unique_ptr <CSearchPolicy> Policy (NewSearchPolicy (PolicyName, DeriveSeed (GameSeed, 1), BudgetMs));
+			if (Policy)
+			{
+				VScores [i] = PlayGame (Game, ref (*Policy));
+				VStats [i]  = Policy->GetStats ();
+			}
+			else
+			{
+				VScores [i] = PlayGame (Game, CRandomPolicy (DeriveSeed (GameSeed, 1)));
+				VStats [i].NbNodes = VStats [i].NbMoves = 0;
+				VStats [i].Seconds = 0;
+			}
+			VNbMoves [i] = Config.NbMaxTimes - Game.NbMovesLeft;
+			if (StatsName.empty ()) return;
+
+			lock_guard <mutex> Lock (StatsMutex);
+			MergeStats (TotalStats, Stats ());
+		});
+		const double Seconds = chrono::duration <double> (chrono::steady_clock::now () - Begin).count ();
+
+		unsigned long long NbMoves (0), NbNodes (0);
+		double Sum (0), SumSquares (0), SearchSeconds (0);
+		unsigned Min (numeric_limits <unsigned>::max ()), Max (0);
+		for (unsigned i (0); i < NbGames; ++i)
+		{
+			NbMoves		+= VNbMoves [i];
+			NbNodes		+= VStats [i].NbNodes;
+			SearchSeconds += VStats [i].Seconds;
+			Sum			+= VScores [i];
+			SumSquares	+= double (VScores [i]) * VScores [i];
+			Min = min (Min, VScores [i]);
+			Max = max (Max, VScores [i]);
+		}
+
+		const double Mean = NbGames ? Sum / NbGames : 0;
+		cout << "Graine            : " << Seed << endl;
+		cout << "Joueur            : " << PolicyName << endl;
+		cout << "Parties           : " << NbGames << endl;
+		cout << "Coups joues       : " << NbMoves << endl;
+		cout << "Score moyen       : " << Mean << endl;
+		cout << "Ecart type        : " << (NbGames ? sqrt (max (0.0, SumSquares / NbGames - Mean * Mean)) : 0) << endl;
+		cout << "Score min / max   : " << (NbGames ? Min : 0) << " / " << Max << endl;
+		cout << "Duree (s)         : " << Seconds << endl;
+		cout << "Coups par seconde : " << (Seconds > 0 ? NbMoves / Seconds : 0) << endl;
+		if (0 != NbNodes)
+		{
+			cout << "Noeuds explores   : " << NbNodes << endl;
+			cout << "Noeuds par seconde: " << (SearchSeconds > 0 ? NbNodes / SearchSeconds : 0) << endl;
+		}
+		if (!StatsName.empty ())
+			ReportStats (TotalStats, StatsName);
+		if (!IsSaveScores) return;
+
+		//the results in one write
+		CVScoreRecord VRecords (NbGames);
+		for (unsigned i (0); i < NbGames; ++i)
+		{
+			VRecords [i].Player		= PolicyName;
+			VRecords [i].Config		= Config;
+			VRecords [i].TotalScore	= VScores [i];
+			VRecords [i].NbMoves	= VNbMoves [i];
+			VRecords [i].Seed		= DeriveSeed (Seed, i);
+			VRecords [i].Date		= time (NULL);
+		}
+		CScoreStore Store;
+		if (!Store.Append (VRecords))
+			cerr << "Erreur d'ecriture du fichier '" << KScoreLogName << "'" << endl;
+
+	}// Simulate ()
+
+	/**
+	* \fn bool : SaveReplay (const CReplay& Replay, const string& FileName)
+	* \brief function to write a replay in a binary file.
+	*
+	* The file holds KReplayMagic, the seed on 8 bytes, the 4 settings, the flag of the special
+	* cells and the number of moves on 4 bytes each, each move on 4 bytes (row, column and
+	* direction, @see KReplayPosBits) and the final score on 4 bytes, all least significant byte first.
+	* A file of KReplayMagicV1 has no flag of the special cells.
+	*
+	*\param Replay : the game to write
+	*\param FileName : the name of the file
+	*/
+	bool SaveReplay (const CReplay& Replay, const string& FileName)
+	{
+		string Buffer (KReplayMagic);
+		AppendLE (Buffer, Replay.Seed, 8);
+		AppendLE (Buffer, Replay.Config.MatHeigth, 4);
+		AppendLE (Buffer, Replay.Config.MatWidth, 4);
+		AppendLE (Buffer, Replay.Config.NbCandies, 4);
+		AppendLE (Buffer, Replay.Config.NbMaxTimes, 4);
+		AppendLE (Buffer, Replay.Config.IsSpecials, 4);
+
+		AppendLE (Buffer, Replay.VMoves.size (), 4);
+		for (unsigned i (0); i < Replay.VMoves.size (); ++i)
+		{
+			const CMove& Move = Replay.VMoves [i];
+			const unsigned Dir = find (KDirections, KDirections + 4, Move.Direction) - KDirections;
+			AppendLE (Buffer, Move.Pos.first | Move.Pos.second << KReplayPosBits | Dir << (2 * KReplayPosBits), 4);
+		}
+		AppendLE (Buffer, Replay.TotalScore, 4);
+
+		ofstream File (FileName.c_str (), ios_base::out | ios_base::binary | ios_base::trunc);
+		File.write (Buffer.data (), Buffer.size ());
+
+		return bool (File);
+
+	}// SaveReplay ()
+
+	/**
+	* \fn bool : LoadReplay (CReplay& Replay, const string& FileName)
+	* \brief function to read a replay, false if the file can not be read or is not a valid replay.
+	*
+	*\param Replay : the game read
+	*\param FileName : the name of the file, @see SaveReplay
+	*/
+	bool LoadReplay (CReplay& Replay, const string& FileName)
+	{
+		ifstream File (FileName.c_str (), ios_base::in | ios_base::binary);
+		if (!File) return false;
+
+		const string Buffer ((istreambuf_iterator <char> (File)), istreambuf_iterator <char> ());
+		const bool IsV1 = 0 == Buffer.compare (0, KReplayMagicV1.size (), KReplayMagicV1);
+		if (!IsV1 && 0 != Buffer.compare (0, KReplayMagic.size (), KReplayMagic)) return false;
+
+		unsigned Offset = KReplayMagic.size ();
+		unsigned long long Heigth, Width, NbCandies, NbMaxTimes, IsSpecials (0), NbMoves, Value;
+		if (!ReadLE (Buffer, Offset, 8, Replay.Seed)	|| !ReadLE (Buffer, Offset, 4, Heigth)
+		 || !ReadLE (Buffer, Offset, 4, Width)			|| !ReadLE (Buffer, Offset, 4, NbCandies)
+		 || !ReadLE (Buffer, Offset, 4, NbMaxTimes)
+		 || (!IsV1 && !ReadLE (Buffer, Offset, 4, IsSpecials))
+		 || !ReadLE (Buffer, Offset, 4, NbMoves))
+			return false;
+
+		const unsigned long long KMaxSize = (1u << KReplayPosBits) - 3;
+		if (!IsBetween (Heigth, 1ULL, KMaxSize) || !IsBetween (Width, 1ULL, KMaxSize)
+		 || !IsBetween (NbCandies, 3ULL, 9ULL) || IsSpecials > 1 || NbMoves > NbMaxTimes
+		 || Buffer.size () != Offset + 4 * NbMoves + 4)
+			return false;
+
+		Replay.Config.MatHeigth		= Heigth;
+		Replay.Config.MatWidth		= Width;
+		Replay.Config.NbCandies		= NbCandies;
+		Replay.Config.NbMaxTimes	= NbMaxTimes;
+		Replay.Config.IsBitBoard	= false;
+		Replay.Config.IsSpecials	= 0 != IsSpecials;
+
+		const unsigned KPosMask = (1u << KReplayPosBits) - 1;
+		Replay.VMoves.resize (NbMoves);
+		for (unsigned i (0); i < NbMoves; ++i)
+		{
+			ReadLE (Buffer, Offset, 4, Value);
+			Replay.VMoves [i].Pos.first		= Value & KPosMask;
+			Replay.VMoves [i].Pos.second	= (Value >> KReplayPosBits) & KPosMask;
+			Replay.VMoves [i].Direction		= KDirections [(Value >> (2 * KReplayPosBits)) & 3];
+		}
+		ReadLE (Buffer, Offset, 4, Value);
+		Replay.TotalScore = Value;
+
+		return true;
+
+	}// LoadReplay ()
+
+	/**
+	* \fn bool : VerifyReplay (const CReplay& Replay, unsigned& TotalScore)
+	* \brief function to play a replay again, without display, and check its final score.
+	*
+	* The numbers refilling the matrix only depend on the seed : the same moves give the same score.
+	*
+	*\param Replay : the game to play again
+	*\param TotalScore : the score obtained, 0 if a move is not valid
+	*/
+	bool VerifyReplay (const CReplay& Replay, unsigned& TotalScore)
+	{
+		CGame Game;
+		InitGame (Game, Replay.Config, Replay.Seed);
+
+		TotalScore = 0;
+		for (unsigned i (0); i < Replay.VMoves.size (); ++i)
+		{
+			const CMove& Move = Replay.VMoves [i];
+			if (0 == Game.NbMovesLeft || !IsMoveValid (Game, Move.Pos, Move.Direction)) return false;
+
+			PlayMove (Game, Move.Pos, Move.Direction);
+		}
+		TotalScore = Game.TotalScore;
+
+		return TotalScore == Replay.TotalScore;
+
+	}// VerifyReplay ()
+
+	/**
+	* \fn ListReplays (const string& DirName, CVString& VFileNames)
+	* \brief function to get the names of the replay files of a directory, sorted.
+	*/
+	void ListReplays (const string& DirName, CVString& VFileNames)
+	{
+		VFileNames.clear ();
+
+		DIR* Dir = opendir (DirName.c_str ());
+		if (!Dir) return;
+
+		for (dirent* Entry = readdir (Dir); Entry; Entry = readdir (Dir))
+		{
+			const string Name (Entry->d_name);
+			if (Name.size () > KReplayExtension.size ()
+			 && 0 == Name.compare (Name.size () - KReplayExtension.size (), KReplayExtension.size (), KReplayExtension))
+				VFileNames.push_back (DirName + "/" + Name);
+		}
+		closedir (Dir);
+
+		sort (VFileNames.begin (), VFileNames.end ());
+
+	}// ListReplays ()
+
+	/**
+	* \fn bool : ReplayFile (const string& FileName)
+	* \brief function to check a replay file and show the result.
+	*/
+	bool ReplayFile (const string& FileName)
+	{
+		CReplay Replay;
+		if (!LoadReplay (Replay, FileName))
+		{
+			cerr << "Fichier de partie invalide '" << FileName << "'" << endl;
+			return false;
+		}
+
+		unsigned TotalScore;
+		const bool IsValid = VerifyReplay (Replay, TotalScore);
+		cout << "Graine            : " << Replay.Seed << endl;
+		cout << "Coups joues       : " << Replay.VMoves.size () << endl;
+		cout << "Score enregistre  : " << Replay.TotalScore << endl;
+		cout << "Score rejoue      : " << TotalScore << endl;
+		cout << (IsValid ? "Partie valide" : "Partie invalide") << endl;
+
+		return IsValid;
+
+	}// ReplayFile ()
+
+	/**
+	* \fn bool : VerifyReplayDir (const string& DirName, const unsigned& NbThreads)
+	* \brief function to check every replay file of a directory in parallel, false if one is not valid.
+	*
+	*\param DirName : the directory
+	*\param NbThreads : how many threads, 0 for one per core
+	*/
+	bool VerifyReplayDir (const string& DirName, const unsigned& NbThreads)
+	{
+		CVString VFileNames;
+		ListReplays (DirName, VFileNames);
+
+		CVLine VIsValid (VFileNames.size ());
+		const chrono::steady_clock::time_point Begin = chrono::steady_clock::now ();
+		ParallelFor (VFileNames.size (), NbThreads, [&] (const unsigned i)
+		{
+			CReplay Replay;
+			unsigned TotalScore;
+			VIsValid [i] = LoadReplay (Replay, VFileNames [i]) && VerifyReplay (Replay, TotalScore);
+		});
+		const double Seconds = chrono::duration <double> (chrono::steady_clock::now () - Begin).count ();
+
+		unsigned NbInvalid (0);
+		for (unsigned i (0); i < VFileNames.size (); ++i)
+		{
+			if (VIsValid [i]) continue;
+
+			cout << "Partie invalide   : " << VFileNames [i] << endl;
+			++NbInvalid;
+		}
+		cout << "Parties verifiees : " << VFileNames.size () << endl;
+		cout << "Parties invalides : " << NbInvalid << endl;
+		cout << "Duree (s)         : " << Seconds << endl;
+
+		return 0 == NbInvalid;
+
+	}// VerifyReplayDir ()
+
+	/** \struct CBenchResult
+	 *
+	 * \brief the measures of a kernel on a matrix size and a number of candies
+	 *
+	 */
+	struct CBenchResult
+	{
+		string		Kernel;				/*!< \brief name of the measured function */
+		unsigned	Heigth;				/*!< \brief number of rows, border excluded */
+		unsigned	Width;				/*!< \brief number of columns, border excluded */
+		unsigned	NbCandies;			/*!< \brief how many different numbers fill the matrix */
+		unsigned	NbCalls;			/*!< \brief calls of each sample */
+		double		NsPerCell;			/*!< \brief mean time of a call per cell, in ns */
+		double		Variance;			/*!< \brief variance of NsPerCell between samples */
+		double		AllocationsPerCall;	/*!< \brief heap allocations of a call */
+	};
+
+	/**
+	* \fn BenchKernel (const function <void ()>& Kernel, const unsigned& NbCells, CBenchResult& Result)
+	* \brief function to measure a kernel : KBenchSamples samples of calls lasting about KBenchSampleNs each.
+	*
+	*\param Kernel : one call of the measured function, with the reset of its input
+	*\param NbCells : the number of cells of the matrix, to get the time per cell
+	*\param Result : receives the number of calls, the time and the allocations
+	*/
+	void BenchKernel (const function <void ()>& Kernel, const unsigned& NbCells, CBenchResult& Result)
+	{
+		typedef chrono::steady_clock CClock;
+
+		//warm up, and find how many calls last KBenchSampleNs
+		CClock::time_point Begin = CClock::now ();
+		Kernel ();
+		const double CallNs = chrono::duration <double, nano> (CClock::now () - Begin).count ();
+		Result.NbCalls = max (1.0, KBenchSampleNs / max (CallNs, 1.0));
+
+		double Sum (0), SumSquares (0);
+		const unsigned long long NbAllocations = AllocationCount ();
+		for (unsigned Sample (0); Sample < KBenchSamples; ++Sample)
+		{
+			Begin = CClock::now ();
+			for (unsigned i (0); i < Result.NbCalls; ++i)
+				Kernel ();
+			const double NsPerCell = chrono::duration <double, nano> (CClock::now () - Begin).count () / Result.NbCalls / NbCells;
+
+			Sum			+= NsPerCell;
+			SumSquares	+= NsPerCell * NsPerCell;
+		}
+
+		Result.AllocationsPerCall	= double (AllocationCount () - NbAllocations) / (KBenchSamples * Result.NbCalls);
+		Result.NsPerCell			= Sum / KBenchSamples;
+		Result.Variance				= max (0.0, (SumSquares - Sum * Sum / KBenchSamples) / (KBenchSamples - 1));
+
+	}// BenchKernel ()
+
+	/**
+	* \fn BenchBoard (const unsigned& Heigth, const unsigned& Width, const unsigned& NbCandies, vector <CBenchResult>& VResults)
+	* \brief function to measure every kernel on a matrix size and a number of candies.
+	*
+	* The kernels changing the matrix start each call from a copy of a prepared matrix : a
+	* random one for FillGrid, HandleGrid and the cascade, one with its sequences removed for
+	* MoveNumbersDown. The searches run on a matrix without sequence, their slowest case.
+	*/
+	void BenchBoard (const unsigned& Heigth, const unsigned& Width, const unsigned& NbCandies, vector <CBenchResult>& VResults)
+	{
+		CRandom Random;
+		Random.SetSeed (DeriveSeed (Heigth * 1000 + Width, NbCandies));
+
+		CVLine VCandies (NbCandies);
+		for (unsigned i (0); i < NbCandies; ++i)
+			VCandies [i] = char ('0' + i + 1);
+
+		CBoard Empty, Filled, Removed, Stable, Grid;
+		InitGrid (Empty, Width + 2, Heigth + 2);
+		Filled = Empty;
+		FillGrid (Filled, VCandies, Random);
+		Stable = Empty;
+		StabilizeGrid (Stable, VCandies, Random);
+
+		CVPair VPosColumn, VPosRow;
+		CVUInt VHowManyCol, VHowManyRow, VNbEmpty;
+		Removed = Filled;
+		HandleGrid (Removed, VPosColumn, VPosRow, VHowManyCol, VHowManyRow);
+
+		CDirtyRegion Dirty;
+		InitDirtyRegion (Dirty, Filled);
+		CTurnScratch Scratch;
+		InitTurnScratch (Scratch, Filled);
+		unsigned TurnScore, Multiplier;
+		volatile unsigned Sink;	//keeps the result of the searches, which would be removed otherwise
+
+		CBenchResult Result;
+		Result.Heigth		= Heigth;
+		Result.Width		= Width;
+		Result.NbCandies	= NbCandies;
+		const unsigned NbCells = Heigth * Width;
+
+		Result.Kernel = "FillGrid";
+		BenchKernel ([&] () { Grid = Empty; FillGrid (Grid, VCandies, Random); }, NbCells, Result);
+		VResults.push_back (Result);
+
+		Result.Kernel = "AtLeastThreeInARow";
+		BenchKernel ([&] () { CPosition Pos (1, 1); unsigned HowMany (0); Sink = AtLeastThreeInARow (Stable, Pos, HowMany) + HowMany; }, NbCells, Result);
+		VResults.push_back (Result);
+
+		Result.Kernel = "AtLeastThreeInColumn";
+		BenchKernel ([&] () { CPosition Pos (1, 1); unsigned HowMany (0); Sink = AtLeastThreeInColumn (Stable, Pos, HowMany) + HowMany; }, NbCells, Result);
+		VResults.push_back (Result);
+
+		Result.Kernel = "IsValueInGrid";
+		BenchKernel ([&] () { Sink = IsValueInGrid (Stable, KImpossible); }, NbCells, Result);
+		VResults.push_back (Result);
+
+		Result.Kernel = "HandleGrid";
+		BenchKernel ([&] ()
+		{
+			Grid = Filled;
+			VPosColumn.clear ();
+			VPosRow.clear ();
+			VHowManyCol.clear ();
+			VHowManyRow.clear ();
+			HandleGrid (Grid, VPosColumn, VPosRow, VHowManyCol, VHowManyRow);
+		}, NbCells, Result);
+		VResults.push_back (Result);
+
+		Result.Kernel = "MoveNumbersDown";
+		BenchKernel ([&] () { Grid = Removed; MoveNumbersDown (Grid, VNbEmpty); }, NbCells, Result);
+		VResults.push_back (Result);
+
+		Result.Kernel = "ResolveCascade";
+		BenchKernel ([&] ()
+		{
+			Grid = Filled;
+			for (unsigned j (1); j <= Width; ++j)
+				MarkDirty (Dirty, 1, Heigth, j);
+			TurnScore = Multiplier = 0;
+			ResolveCascade (Grid, VCandies, Random, Dirty, Scratch, TurnScore, Multiplier, NULL);
+		}, NbCells, Result);
+		VResults.push_back (Result);
+
+		CVMove VMoves;
+		Result.Kernel = "ListMatchingMoves";
+		BenchKernel ([&] () { ListMatchingMoves (Stable, VMoves); }, NbCells, Result);
+		VResults.push_back (Result);
+
+		CGameConfig Config;
+		Config.MatHeigth	= Heigth;
+		Config.MatWidth		= Width;
+		Config.NbCandies	= NbCandies;
+		const CRules& Rules = SelectRules (Config);
+		if (&Rules != &ShapeRules <CAnyShape> ())
+		{
+			Result.Kernel = "ListMatchingMovesFixed";
+			BenchKernel ([&] () { Rules.ListMatchingMoves (Stable, VMoves); }, NbCells, Result);
+			VResults.push_back (Result);
+		}
+
+		if (CBitBoard::Fits (Heigth, Width, NbCandies))
+		{
+			CBitBoard Bits;
+			Result.Kernel = "ResolveBitCascade";
+			BenchKernel ([&] ()
+			{
+				Grid = Filled;
+				Bits.FromBoard (Grid, NbCandies);
+				TurnScore = Multiplier = 0;
+				ResolveBitCascade (Bits, Random, CPosition (1, 1), CPosition (1, 2), TurnScore, Multiplier, false, Grid);
+			}, NbCells, Result);
+			VResults.push_back (Result);
+		}
+
+	}// BenchBoard ()
+
+	/**
+	* \fn bool : Bench (const string& FileName)
+	* \brief function to measure the kernels on every size of KBenchSizes and 3 to 7 candies, and write the results in a JSON file.
+	*
+	*\param FileName : the name of the JSON file
+	*\return false if the file can not be written
+	*/
+	bool Bench (const string& FileName)
+	{
+		vector <CBenchResult> VResults;
+		for (unsigned s (0); s < KNbBenchSizes; ++s)
+			for (unsigned NbCandies (3); NbCandies <= 7; ++NbCandies)
+			{
+				const unsigned First = VResults.size ();
+				BenchBoard (KBenchSizes [s], KBenchSizes [s], NbCandies, VResults);
+
+				for (unsigned i (First); i < VResults.size (); ++i)
+					cout << setw (24) << left << VResults [i].Kernel << right
+						 << setw (5) << VResults [i].Heigth << "x" << setw (5) << left << VResults [i].Width << right
+						 << setw (2) << VResults [i].NbCandies << " nombres : "
+						 << setw (10) << VResults [i].NsPerCell << " ns/case, "
+						 << VResults [i].AllocationsPerCall << " allocation(s)" << endl;
+			}
+
+		ofstream File (FileName.c_str (), ios_base::out | ios_base::trunc);
+		File << "{" << endl
+			 << "  \"date\": " << time (NULL) << "," << endl
+#ifdef __VERSION__
+			 << "  \"compiler\": \"" << __VERSION__ << "\"," << endl
+#endif
+			 << "  \"samples\": " << KBenchSamples << "," << endl
+			 << "  \"results\": [" << endl;
+		for (unsigned i (0); i < VResults.size (); ++i)
+		{
+			const CBenchResult& Result = VResults [i];
+			File << "    {\"kernel\": \"" << Result.Kernel << "\""
+				 << ", \"rows\": " << Result.Heigth
+				 << ", \"columns\": " << Result.Width
+				 << ", \"candies\": " << Result.NbCandies
+				 << ", \"calls\": " << Result.NbCalls
+				 << ", \"ns_per_cell\": " << Result.NsPerCell
+				 << ", \"variance\": " << Result.Variance
+				 << ", \"allocations_per_call\": " << Result.AllocationsPerCall
+				 << "}" << (i + 1 < VResults.size () ? "," : "") << endl;
+		}
+		File << "  ]" << endl << "}" << endl;
+
+		return bool (File);
+
+	}// Bench ()
+
+	/**
+	* \fn RaiseFileLimit ()
+	* \brief function to allow the process as many open files as the system lets it, one per client.
+	*/
+	void RaiseFileLimit ()
+	{
+		rlimit Limit;
+		if (0 != getrlimit (RLIMIT_NOFILE, &Limit)) return;
+
+		Limit.rlim_cur = Limit.rlim_max;
+		setrlimit (RLIMIT_NOFILE, &Limit);
+
+	}// RaiseFileLimit ()
+
+	/**
+	* \fn OpenSession (CSession& Session, const int& Socket, const CGameConfig& Config, const unsigned long long& Seed)
+	* \brief function to start the game of a new client in a free slot, and greet it.
+	*
+	* The greeting is "NUMBERCRUSH seed rows columns moves" : the seed lets the game be played again.
+	*/
+	void OpenSession (CSession& Session, const int& Socket, const CGameConfig& Config, const unsigned long long& Seed)
+	{
+		Session.Socket		= Socket;
+		Session.IsWriting	= false;
+		Session.IsClosing	= false;
+		Session.Input.clear ();
+		InitGame (Session.Game, Config, Seed);
+
+		ostringstream Greeting;
+		Greeting << KServerGreeting << ' ' << Seed << ' ' << Config.MatHeigth << ' ' << Config.MatWidth << ' ' << Config.NbMaxTimes << '\n';
+		Session.Output = Greeting.str ();
+
+	}// OpenSession ()
+
+	/**
+	* \fn bool : HandleSessionLine (CSession& Session, const string& Line)
+	* \brief function to answer a line sent by a client of the server, the answer being appended to Session.Output.
+	*
+	* "row col dir" plays a move, as read by CutInputStr, and is answered "OK score moves-left" or
+	* "ERR Commande invalide" ; once no move is left, it is answered "FIN score".
+	* "H" is answered "INDICE row col dir" or "AUCUN", and "Q" ends the session.
+	*
+	*\param Session : the client and its game
+	*\param Line : the line, without its end
+	*\return false if the client leaves
+	*/
+	bool HandleSessionLine (CSession& Session, const string& Line)
+	{
+		CGame& Game = Session.Game;
+		string& Output = Session.Output;
+		const char* Cursor = Line.c_str ();
+		const char* Begin;
+		const char* End;
+		if (!NextToken (Cursor, Begin, End)) return true;
+
+		if (1 == End - Begin && 'Q' == toupper (*Begin)) return false;
+
+		if (1 == End - Begin && KHintCommand == toupper (*Begin))
 		{
-			VPosRow.push_back (Pos);
-			VHowManyRow.push_back (HowMany);
-			++Pos.second;
+			CMove Hint;
+			if (!Game.Rules->FindHint (Game.Grid, Hint))
+			{
+				Output += "AUCUN\n";
+				return true;
+			}
+			Output += "INDICE ";
+			AppendUInt (Output, Hint.Pos.first);
+			Output += ' ';
+			AppendUInt (Output, Hint.Pos.second);
+			Output += ' ';
+			Output += Hint.Direction;
+			Output += '\n';
+			return true;
 		}
-		
-		//remove sequences
-		for (unsigned i (0); i < VPosColumn.size (); ++i)
-			RemovalInColumn (Grid, VPosColumn [i], VHowManyCol [i]);
-		for (unsigned i (0); i < VPosRow.size (); ++i)
-			RemovalInRow (Grid, VPosRow [i], VHowManyRow [i]);
 
-	}// HandleGrid ()
+		if (0 == Game.NbMovesLeft)
+		{
+			Output += "FIN ";
+			AppendUInt (Output, Game.TotalScore);
+			Output += '\n';
+			return true;
+		}
+
+		CPosition Pos (0, 0);
+		char Direction;
+		CutInputStr (Line, Pos, Direction);
+		if (!IsMoveValid (Game, Pos, Direction))
+		{
+			Output += "ERR Commande invalide\n";
+			return true;
+		}
+
+		PlayMove (Game, Pos, Direction);
+		Output += "OK ";
+		AppendUInt (Output, Game.TotalScore);
+		Output += ' ';
+		AppendUInt (Output, Game.NbMovesLeft);
+		Output += '\n';
+
+		return true;
+
+	}// HandleSessionLine ()
+
+					/**
+					* \fn bool : Test_HandleSessionLine ()
+					* \brief test function @see HandleSessionLine : a game played with the hints of the server, then refused.
+					*/
+					bool Test_HandleSessionLine ()
+					{
+						CGameConfig Config = MakeTestConfig (10, 10, 5, 3, true);
+
+						CSession Session;
+						OpenSession (Session, -1, Config, 42);
+						unsigned NbErrors (0);
+						if (0 != Session.Output.compare (0, KServerGreeting.size () + 4, KServerGreeting + " 42 ")) ++NbErrors;
+
+						for (unsigned Move (0); Move < Config.NbMaxTimes; ++Move)
+						{
+							Session.Output.clear ();
+							if (!HandleSessionLine (Session, "h\r") || 0 != Session.Output.compare (0, 7, "INDICE ")) ++NbErrors;
+
+							const string Hint (Session.Output, 7, Session.Output.size () - 8);
+							Session.Output.clear ();
+							if (!HandleSessionLine (Session, Hint) || 0 != Session.Output.compare (0, 3, "OK ")) ++NbErrors;
+						}
+						if (0 != Session.Game.NbMovesLeft) ++NbErrors;
+
+						Session.Output.clear ();
+						HandleSessionLine (Session, "   ");
+						HandleSessionLine (Session, "1 1 x");
+						if (Session.Output != "FIN " + to_string (Session.Game.TotalScore) + "\n") ++NbErrors;
+						if (HandleSessionLine (Session, " q ")) ++NbErrors;
+
+						OpenSession (Session, -1, Config, 42);
+						Session.Output.clear ();
+						HandleSessionLine (Session, "0 1 z");
+						if (Session.Output != "ERR Commande invalide\n" || 3 != Session.Game.NbMovesLeft) ++NbErrors;
+						return ReportTest ("Test_HandleSessionLine", NbErrors);
+
+					}// Test_HandleSessionLine ()
 
 	/**
-	* \fn   PlayScoreMod ()
-	* \brief function to play score mod.
+	* \fn bool : ReadSessionLines (CSession& Session, string& Line)
+	* \brief function to answer the complete lines received from a client, keeping the end of the last one.
 	*
+	*\param Line : buffer of a line, reused by every client
+	*\return false if the client sent a line longer than KMaxLineSize
 	*/
-	void PlayScoreMod ()	//play score mod
+	bool ReadSessionLines (CSession& Session, string& Line)
 	{
-		//init variables with config file
-		CVString VConfig;
-		FileToVectStr (VConfig, KConfigFileName);
+		size_t Begin (0);
+		for (size_t End; !Session.IsClosing && string::npos != (End = Session.Input.find ('\n', Begin)); Begin = End + 1)
+		{
+			Line.assign (Session.Input, Begin, End - Begin);
+			Session.IsClosing = !HandleSessionLine (Session, Line);
+		}
+		if (Session.IsClosing)
+			Session.Input.clear ();
+		else
+			Session.Input.erase (0, Begin);
 
-		const unsigned MatHeigth	= ConvertStr <unsigned> (TakeValueInVectStr ("MatrixHeigth", VConfig)) + 2;
-		const unsigned MatWidth		= ConvertStr <unsigned> (TakeValueInVectStr ("MatrixWidth", VConfig)) + 2;
-		const unsigned NbCandies 	= ConvertStr <unsigned> (TakeValueInVectStr ("NbCandies", VConfig));
-		unsigned NbMaxTimes 		= ConvertStr <unsigned> (TakeValueInVectStr ("NbMaxTimes", VConfig));
+		return Session.Input.size () <= KMaxLineSize;
 
-		unsigned TotalScore (0);
-		unsigned TurnScore  (0);
-		unsigned Multiplier (0);
+	}// ReadSessionLines ()
 
-		//init VCandies
-		CVLine VCandies (NbCandies);
-		for (unsigned i = (0); i < VCandies.size (); ++i)
-			VCandies [i] = char ('0' + i + 1);
+	/**
+	* \fn bool : FlushSession (CSession& Session, const int& Epoll, const unsigned& Slot)
+	* \brief function to send what the socket accepts of Session.Output, and watch the socket until it accepts the rest.
+	*
+	*\return false if the session is over : an error, or a client leaving with nothing left to send
+	*/
+	bool FlushSession (CSession& Session, const int& Epoll, const unsigned& Slot)
+	{
+		size_t Sent (0);
+		for (ssize_t Size; Sent < Session.Output.size (); Sent += Size)
+		{
+			Size = send (Session.Socket, Session.Output.data () + Sent, Session.Output.size () - Sent, MSG_NOSIGNAL);
+			if (Size >= 0) continue;
 
-		//init board
-		CMat Matrix;
-		InitGrid (Matrix, MatWidth, MatHeigth);
-		
-		for ( ; IsValueInGrid (Matrix, KImpossible); )
+			if (EAGAIN != errno && EWOULDBLOCK != errno) return false;
+			break;
+		}
+		Session.Output.erase (0, Sent);
+
+		const bool IsWriting = !Session.Output.empty ();
+		if (IsWriting != Session.IsWriting)
+		{
+			epoll_event Event = epoll_event ();
+			Event.events	= IsWriting ? EPOLLIN | EPOLLOUT : EPOLLIN;
+			Event.data.u32	= Slot;
+			epoll_ctl (Epoll, EPOLL_CTL_MOD, Session.Socket, &Event);
+			Session.IsWriting = IsWriting;
+		}
+
+		return IsWriting || !Session.IsClosing;
+
+	}// FlushSession ()
+
+	/**
+	* \fn CloseSession (CSession& Session, CVUInt& VFree, const unsigned& Slot)
+	* \brief function to close the socket of a client and give its slot back to the pool.
+	*/
+	void CloseSession (CSession& Session, CVUInt& VFree, const unsigned& Slot)
+	{
+		close (Session.Socket);
+		Session.Socket = -1;
+		Session.Input.clear ();
+		Session.Output.clear ();
+		VFree.push_back (Slot);
+
+	}// CloseSession ()
+
+	/**
+	* \fn bool : Serve (const CGameConfig& Config, const unsigned& Port, const unsigned long long& Seed)
+	* \brief function to host the games of many clients on a TCP port, until an error.
+	*
+	* A single thread waits on every socket with epoll. Each client gets a slot of a pool of
+	* KMaxSessions games allocated once, a new client being refused when they are all taken.
+	* The game of the client number i is seeded with DeriveSeed (Seed, i), @see HandleSessionLine for the protocol.
+	*
+	*\param Config : settings of the games
+	*\param Port : the port listened to, on every address
+	*\param Seed : master seed
+	*\return false if the port can not be listened to
+	*/
+	bool Serve (const CGameConfig& Config, const unsigned& Port, const unsigned long long& Seed)
+	{
+		RaiseFileLimit ();
+
+		const int Yes (1);
+		sockaddr_in Address = sockaddr_in ();
+		Address.sin_family		= AF_INET;
+		Address.sin_addr.s_addr	= htonl (INADDR_ANY);
+		Address.sin_port		= htons (Port);
+		const int Listener = socket (AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+		const int Epoll = epoll_create1 (0);
+		epoll_event Event = epoll_event ();
+		Event.events	= EPOLLIN;
+		Event.data.u32	= KMaxSessions;
+		if (!IsBetween (Port, 1u, KMaxPort) || Listener < 0 || Epoll < 0
+		 || 0 != setsockopt (Listener, SOL_SOCKET, SO_REUSEADDR, &Yes, sizeof (Yes))
+		 || 0 != bind (Listener, (const sockaddr*) &Address, sizeof (Address))
+		 || 0 != listen (Listener, SOMAXCONN)
+		 || 0 != epoll_ctl (Epoll, EPOLL_CTL_ADD, Listener, &Event))
+		{
+			cerr << "Erreur d'ouverture du port " << Port << " : " << strerror (errno) << endl;
+			if (0 <= Listener) close (Listener);
+			if (0 <= Epoll) close (Epoll);
+			return false;
+		}
+
+		vector <CSession> VSessions (KMaxSessions);
+		CVUInt VFree (KMaxSessions);
+		for (unsigned i (0); i < KMaxSessions; ++i)
+		{
+			VSessions [i].Socket = -1;
+			VFree [i] = KMaxSessions - 1 - i;
+		}
+		cout << "Serveur a l'ecoute sur le port " << Port << endl;
+
+		unsigned long long NbClients (0);
+		epoll_event VEvents [KServerEvents];
+		char Buffer [KSocketBufferSize];
+		string Line;
+		for ( ; ; )
+		{
+			const int NbEvents = epoll_wait (Epoll, VEvents, KServerEvents, -1);
+			if (NbEvents < 0 && EINTR != errno) break;
+
+			for (int e (0); e < NbEvents; ++e)
+			{
+				const unsigned Slot = VEvents [e].data.u32;
+				if (KMaxSessions == Slot)
+				{
+					//the new clients
+					for (int Socket; 0 <= (Socket = accept4 (Listener, NULL, NULL, SOCK_NONBLOCK)); )
+					{
+						if (VFree.empty ())
+						{
+							send (Socket, "ERR Serveur complet\n", 20, MSG_NOSIGNAL);
+							close (Socket);
+							continue;
+						}
+						setsockopt (Socket, IPPROTO_TCP, TCP_NODELAY, &Yes, sizeof (Yes));
+
+						const unsigned New = VFree.back ();
+						VFree.pop_back ();
+						CSession& Session = VSessions [New];
+						OpenSession (Session, Socket, Config, DeriveSeed (Seed, NbClients++));
+						Event.events	= EPOLLIN;
+						Event.data.u32	= New;
+						if (0 != epoll_ctl (Epoll, EPOLL_CTL_ADD, Socket, &Event) || !FlushSession (Session, Epoll, New))
+							CloseSession (Session, VFree, New);
+					}
+					continue;
+				}
+
+				//the lines of a client, answered at once
+				CSession& Session = VSessions [Slot];
+				if (-1 == Session.Socket) continue;
+
+				ssize_t Size (0);
+				bool IsOpen (true);
+				for ( ; IsOpen && 0 < (Size = recv (Session.Socket, Buffer, sizeof (Buffer), 0)); )
+				{
+					Session.Input.append (Buffer, Size);
+					IsOpen = ReadSessionLines (Session, Line);
+				}
+				IsOpen = IsOpen && Size < 0 && (EAGAIN == errno || EWOULDBLOCK == errno);
+
+				if (!IsOpen || !FlushSession (Session, Epoll, Slot))
+					CloseSession (Session, VFree, Slot);
+			}
+		}
+		cerr << "Erreur du serveur : " << strerror (errno) << endl;
+		close (Epoll);
+		close (Listener);
+
+		return false;
+
+	}// Serve ()
+
+	/**
+	* \fn double : Percentile (const vector <double>& VSorted, const double& Ratio)
+	* \brief function to get the value under which a ratio of the sorted values are, 0 if there is none.
+	*/
+	double Percentile (const vector <double>& VSorted, const double& Ratio)
+	{
+		if (VSorted.empty ()) return 0;
+
+		return VSorted [min (VSorted.size () - 1, size_t (Ratio * VSorted.size ()))];
+
+	}// Percentile ()
+
+	/**
+	* \fn bool : LoadTest (const unsigned& Port, const unsigned& NbClients)
+	* \brief function to play many games at once against a server of the local machine, and show the latency of the moves.
+	*
+	* Every client asks for a hint then plays it, until its game is over. The latency of a move is
+	* the time between the move being sent and its answer being read.
+	*
+	*\param Port : the port of the server, @see Serve
+	*\param NbClients : how many clients play at once
+	*\return false if a client could not play its whole game
+	*/
+	bool LoadTest (const unsigned& Port, const unsigned& NbClients)
+	{
+		RaiseFileLimit ();
+
+		const int Yes (1);
+		sockaddr_in Address = sockaddr_in ();
+		Address.sin_family		= AF_INET;
+		Address.sin_addr.s_addr	= htonl (INADDR_LOOPBACK);
+		Address.sin_port		= htons (Port);
+		const int Epoll = epoll_create1 (0);
+		if (!IsBetween (Port, 1u, KMaxPort) || Epoll < 0)
+		{
+			cerr << "Erreur de connexion au port " << Port << endl;
+			if (0 <= Epoll) close (Epoll);
+			return false;
+		}
+
+		const chrono::steady_clock::time_point Begin = chrono::steady_clock::now ();
+		vector <CLoadClient> VClients (NbClients);
+		unsigned NbOpen (0), NbErrors (0);
+		for (unsigned i (0); i < NbClients; ++i)
+		{
+			CLoadClient& Client = VClients [i];
+			Client.Socket = socket (AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+			epoll_event Event = epoll_event ();
+			Event.events	= EPOLLIN;
+			Event.data.u32	= i;
+			if (Client.Socket < 0
+			 || (0 != connect (Client.Socket, (const sockaddr*) &Address, sizeof (Address)) && EINPROGRESS != errno)
+			 || 0 != epoll_ctl (Epoll, EPOLL_CTL_ADD, Client.Socket, &Event))
+			{
+				cerr << "Erreur de connexion au port " << Port << " : " << strerror (errno) << endl;
+				if (0 <= Client.Socket) close (Client.Socket);
+				Client.Socket = -1;
+				++NbErrors;
+				continue;
+			}
+			setsockopt (Client.Socket, IPPROTO_TCP, TCP_NODELAY, &Yes, sizeof (Yes));
+			++NbOpen;
+		}
+
+		vector <double> VLatencies;
+		unsigned long long TotalScore (0);
+		epoll_event VEvents [KServerEvents];
+		char Buffer [KSocketBufferSize];
+		string Reply;
+		for ( ; 0 != NbOpen; )
 		{
-			CVPair VPosCol, VPosRow;
-			CVUInt VHowManyCol, VHowManyRow;
+			const int NbEvents = epoll_wait (Epoll, VEvents, KServerEvents, -1);
+			if (NbEvents < 0 && EINTR != errno) break;
+
+			for (int e (0); e < NbEvents; ++e)
+			{
+				CLoadClient& Client = VClients [VEvents [e].data.u32];
+				if (-1 == Client.Socket) continue;
+
+				ssize_t Size;
+				for ( ; 0 < (Size = recv (Client.Socket, Buffer, sizeof (Buffer), 0)); )
+					Client.Input.append (Buffer, Size);
+				bool IsOpen = Size < 0 && (EAGAIN == errno || EWOULDBLOCK == errno);
+				bool IsOver (false);
+
+				//the server answers each line with one line
+				Reply.clear ();
+				size_t LineBegin (0);
+				for (size_t LineEnd; !IsOver && string::npos != (LineEnd = Client.Input.find ('\n', LineBegin)); LineBegin = LineEnd + 1)
+				{
+					const char* Cursor = Client.Input.c_str () + LineBegin;
+					const char* Word;
+					const char* WordEnd;
+					NextToken (Cursor, Word, WordEnd);
+					const string Answer (Word, WordEnd);
+					if (Answer == KServerGreeting)
+						Reply = "H\n";
+					else if (Answer == "INDICE")
+					{
+						Reply.assign (Cursor, Client.Input.c_str () + LineEnd + 1);
+						Client.MoveTime = chrono::steady_clock::now ();
+					}
+					else if (Answer == "OK")
+					{
+						VLatencies.push_back (chrono::duration <double, micro> (chrono::steady_clock::now () - Client.MoveTime).count ());
+						unsigned Score (0), NbMovesLeft (0);
+						if (NextToken (Cursor, Word, WordEnd)) ParseUInt (Word, WordEnd, Score);
+						if (NextToken (Cursor, Word, WordEnd)) ParseUInt (Word, WordEnd, NbMovesLeft);
+						IsOver = 0 == NbMovesLeft;
+						Reply = IsOver ? "Q\n" : "H\n";
+						if (IsOver) TotalScore += Score;
+					}
+					else
+					{
+						//AUCUN, FIN or ERR : the game can not go on
+						if (Answer == "ERR") ++NbErrors;
+						IsOver = true;
+					}
+				}
+				Client.Input.erase (0, LineBegin);
+
+				if (!Reply.empty () && send (Client.Socket, Reply.data (), Reply.size (), MSG_NOSIGNAL) != ssize_t (Reply.size ()))
+					IsOpen = false;
+				if (IsOpen && !IsOver) continue;
 
-			FillGrid (Matrix, VCandies);
-			HandleGrid (Matrix, VPosCol, VPosRow, VHowManyCol, VHowManyRow);
-			MoveNumbersDown (Matrix);
+				if (!IsOver) ++NbErrors;
+				close (Client.Socket);
+				Client.Socket = -1;
+				--NbOpen;
+			}
 		}
+		close (Epoll);
+		const double Seconds = chrono::duration <double> (chrono::steady_clock::now () - Begin).count ();
+
+		sort (VLatencies.begin (), VLatencies.end ());
+		cout << "Clients           : " << NbClients << endl;
+		cout << "Coups joues       : " << VLatencies.size () << endl;
+		cout << "Erreurs           : " << NbErrors << endl;
+		cout << "Score moyen       : " << (NbClients ? double (TotalScore) / NbClients : 0) << endl;
+		cout << "Duree (s)         : " << Seconds << endl;
+		cout << "Coups par seconde : " << (Seconds > 0 ? VLatencies.size () / Seconds : 0) << endl;
+		cout << "Latence p50 (us)  : " << Percentile (VLatencies, 0.50) << endl;
+		cout << "Latence p99 (us)  : " << Percentile (VLatencies, 0.99) << endl;
+
+		return 0 == NbErrors;
+
+	}// LoadTest ()
+
+	/**
+	* \fn   PlayScoreMod (const CConfig& Settings, const string& StatsName)
+	* \brief function to play score mod.
+	*
+	*\param Settings : the config
+	*\param StatsName : the JSON file receiving the counters of the instrumentation at the end of the game, none if empty
+	*/
+	void PlayScoreMod (const CConfig& Settings, const string& StatsName)	//play score mod
+	{
+		Stats () = CStats ();
+
+		//init game with config file
+		CGameConfig Config;
+		LoadGameConfig (Settings, Config);
+
+		CReplay Replay;
+		Replay.Seed		= Settings.Get ("Seed") ? Settings.Get ("Seed") : (unsigned long long) time (NULL);
+		Replay.Config	= Config;
+
+		CGame Game;
+		InitGame (Game, Config, Replay.Seed);
+
+		CVString VHelp;
+		FileToVectStr (VHelp, KHelpFileName);
+		CRenderer Renderer (VHelp);
+
+		const unsigned Fps = IsLargeBoard (Game.Grid) ? 0 : Settings.Get ("AnimationFps");	//the playback copies the matrix
+		CAnimation Animation (Fps);
+		CUndoLog Log;
+		CVUInt VSteps;
+		string Input;
+		Replay.VMoves.reserve (Config.NbMaxTimes);
 
 		//start game
-		for ( ; 0 != NbMaxTimes; )
+		for ( ; 0 != Game.NbMovesLeft; )
 		{
 			//display board
-			ClearScreen 	();
-			DisplayScore 	(TotalScore, TurnScore, Multiplier);
-			DisplayGrid 	(Matrix);
-			cout << "Nombre de coups restant : " << NbMaxTimes << endl << endl;
-			
-			DisplayFileContents (KHelpFileName);
-			cout << endl << "Entrez une commande : ";
+			Renderer.Draw (Game, Game.IsShuffled ? KShuffledStatus : KNoStatus);
 
 			//input interpreter
-			string Input;
-			CMat M = Matrix;
-			for ( ; M == Matrix; )
+			CPosition InputPos;
+			char InputDir;
+			for ( ; ; )
 			{
-				CPosition InputPos;
-				char InputDir;
-
 				CatchInput  (Input);
+				if (1 == Input.size () && KHintCommand == toupper (Input [0]))
+				{
+					CMove Hint;
+					if (Game.Rules->FindHint (Game.Grid, Hint))
+						cout << "Indice : " << Hint.Pos.first << " " << Hint.Pos.second << " " << Hint.Direction << endl;
+					else
+						cout << "Aucun coup ne forme de suite" << endl;
+					continue;
+				}
+				if (!Input.empty () && KViewCommand == toupper (Input [0]))
+				{
+					CPosition Center (0, 0);
+					CutInputStr (Input.substr (1), Center, InputDir);
+					Renderer.CenterView (Game.Grid, Center);
+					Renderer.Draw (Game, KNoStatus);
+					continue;
+				}
 				CutInputStr (Input, InputPos, InputDir);
 
-				if (IsBetween (InputPos.first, 1u, MatHeigth - 2) && IsBetween (InputPos.second, 1u, MatWidth - 2))
-					MakeAMove (Matrix, InputPos, InputDir);
-				else
-					cout << "Commande invalide" << endl;
-				if (IsValueInGrid (Matrix, KImpossible))
-					MakeAMove (Matrix, InputPos, InputDir);
+				if (IsMoveValid (Game, InputPos, InputDir)) break;
+				cout << "Commande invalide" << endl;
 			}
 
+			CMove Move;
+			Move.Pos		= InputPos;
+			Move.Direction	= InputDir;
+			Replay.VMoves.push_back (Move);
+
 			//manipulate matrix and increase score
-			TurnScore = Multiplier = 0;
-			unsigned Score;
-			do
+			if (0 == Fps)
 			{
-				Score = TurnScore;
-				CVPair VPosCol, VPosRow;
-				CVUInt VHowManyCol, VHowManyRow;
-				
-				HandleGrid (Matrix, VPosCol, VPosRow, VHowManyCol, VHowManyRow);
-				MoveNumbersDown (Matrix);
-				FillGrid (Matrix, VCandies);
-
-				for (unsigned i : VHowManyCol)
-					TurnScore += i * KSquareValue;
-				for (unsigned i : VHowManyRow)
-					TurnScore += i * KSquareValue;
-				Multiplier += VHowManyCol.size () + VHowManyRow.size ();
-				
-			}while (Score != TurnScore);
-
-			TotalScore += TurnScore * Multiplier;
+				PlayMove (Game, InputPos, InputDir);
+				continue;
+			}
 
-			--NbMaxTimes;
+			//the move is resolved at once, then played back step by step
+			Log.Clear ();
+			VSteps.clear ();
+			PlayMove (Game, InputPos, InputDir, &Log, &VSteps);
+			Animation.Start (Game.Grid, Log, 0, VSteps);
+			for ( ; Animation.Tick (Renderer, Game); )
+				this_thread::sleep_until (Animation.GetDeadline ());
 		}
 
 		//show final score
 		ClearScreen ();
-		cout << "Votre score : " << TotalScore << endl;
+		cout << "Votre score : " << Game.TotalScore << endl;
+		if (!StatsName.empty ())
+			ReportStats (Stats (), StatsName);
+
+		//record the game to replay it
+		Replay.TotalScore = Game.TotalScore;
+		ostringstream FileName;
+		FileName << KReplayDirName << "/partie-" << time (NULL) << "-" << Replay.Seed << KReplayExtension;
+		mkdir (KReplayDirName.c_str (), 0755);
+		if (SaveReplay (Replay, FileName.str ()))
+			cout << "Partie enregistree dans '" << FileName.str () << "'" << endl;
+		else
+			cerr << "Erreur d'ecriture du fichier '" << FileName.str () << "'" << endl;
+
+		//record the score and show the best ones of these settings
+		if (Settings.Get ("SaveScores"))
+		{
+			CVScoreRecord VRecords (1);
+			cout << "Votre nom : ";
+			CatchInput (VRecords [0].Player);
+			VRecords [0].Config		= Config;
+			VRecords [0].TotalScore	= Game.TotalScore;
+			VRecords [0].NbMoves	= Config.NbMaxTimes - Game.NbMovesLeft;
+			VRecords [0].Seed		= Replay.Seed;
+			VRecords [0].Date		= time (NULL);
+			CScoreStore Store;
+			if (!Store.Append (VRecords))
+				cerr << "Erreur d'ecriture du fichier '" << KScoreLogName << "'" << endl;
+			ShowBestScores (KShownScores, &Config);
+		}
 		Pause ();
 
 	}// PlayScoreMode ()
 
 	/**
-	* \fn   ChangeSettings ()
+	* \fn   ChangeSettings (CConfig& Settings)
 	* \brief function to change settings of the game.
 	*
+	*\param Settings : the config, saved at each change
 	*/
-	void ChangeSettings ()
+	void ChangeSettings (CConfig& Settings)
 	{
 		ClearScreen ();
 
 		string Input;
 		for ( ; Input != "Q"; )
 		{
-			CVString VConfig;
-		FileToVectStr (VConfig, KConfigFileName);
-		cout << "hauteur" << "  =  " << TakeValueInVectStr ("MatrixWidth", VConfig) << endl;
-		cout << "largeur" << "  =  " << TakeValueInVectStr ("MatrixHeigth", VConfig) << endl;
-		cout << "nombres" << "  =  " << TakeValueInVectStr ("NbCandies", VConfig) << endl << endl;
+			cout << "hauteur" << "  =  " << Settings.Get ("MatrixWidth") << endl;
+			cout << "largeur" << "  =  " << Settings.Get ("MatrixHeigth") << endl;
+			cout << "nombres" << "  =  " << Settings.Get ("NbCandies") << endl;
+			cout << "animation" << "  =  " << Settings.Get ("AnimationFps") << " images par seconde" << endl << endl;
 
 			cout << "Entrez le nom du paramètre suivi de la valeur que vous souhaitez lui attribuer." << endl
 				 << "Tapez 'Q' pour quitter." << endl
@@ -780,33 +7254,26 @@ namespace nsNumberCrush
 
 			iss >> tmp;
 			iss >> Value;
-			unsigned Min, Max;
 
 			if (tmp == "hauteur")
-			{
 				Label = "MatrixWidth";
-				Min = 5;
-				Max = 15;
-			}
 			else if (tmp == "largeur")
-			{
 				Label = "MatrixHeigth";
-				Min = 5;
-				Max = 20;
-			}
 			else if (tmp == "nombres")
-			{
 				Label = "NbCandies";
-				Min = 3;
-				Max = 7;
-			}
+			else if (tmp == "animation")
+				Label = "AnimationFps";
 			else
-				cout << "Commande invalide" << endl;
+			{
+				if (Input != "Q")
+					cout << "Commande invalide" << endl;
+				continue;
+			}
 
-			if (IsOfType <unsigned> (Value) && IsBetween (ConvertStr <unsigned> (Value), Min, Max))
-				ChangeValueInFile (Label, KConfigFileName, Value);
-			else
+			if (!IsOfType <unsigned> (Value) || !Settings.Set (Label, ConvertStr <unsigned> (Value)))
 				cout << "Valeur invalide" << endl;
+			else if (!Settings.Save ())
+				cerr << "Erreur d'ecriture du fichier '" << KConfigFileName << "'" << endl;
 		}
 		
 		ClearScreen ();
@@ -814,14 +7281,16 @@ namespace nsNumberCrush
 	}
 
 	/**
-	* \fn   MainMenu ()
+	* \fn   MainMenu (CConfig& Settings, const string& StatsName)
 	* \brief function used to display the menu.
 	*
+	*\param Settings : the config of the session
+	*\param StatsName : @see PlayScoreMod
 	*/
-	void MainMenu ()
+	void MainMenu (CConfig& Settings, const string& StatsName)
 	{
 		string Str;
-		for ( ;	Str != "4"; )
+		for ( ;	Str != "5"; )
 		{
 			//display menu
 			ClearScreen ();
@@ -833,16 +7302,25 @@ namespace nsNumberCrush
 			switch (ConvertStr <char> (Str))
 			{
 				case '1':
-					PlayScoreMod ();	//play score mod
+					PlayScoreMod (Settings, StatsName);	//play score mod
 					break;
 				case '2':
 					DisplayFileContents (KRulesFileName);	//display rules
 					Pause ();
 					break;
 				case '3':
-					ChangeSettings ();	//change settings
+					ChangeSettings (Settings);	//change settings
 					break;
 				case '4':
+				{
+					CGameConfig Config;	//the best scores of the current settings
+					LoadGameConfig (Settings, Config);
+					ClearScreen ();
+					ShowBestScores (KShownScores, &Config);
+					Pause ();
+					break;
+				}
+				case '5':
 					ClearScreen ();
 					cout << "developped by" << endl;
 					DisplayFileContents (KCreditsFileName);	//display credits
@@ -855,23 +7333,252 @@ namespace nsNumberCrush
 
 	}// MainMenu ()
 
+	/**
+	* \fn bool : RunTests ()
+	* \brief function to run every test function and show how many failed.
+	*
+	*\return true if none failed
+	*/
+	bool RunTests ()
+	{
+		typedef bool (*CTest) ();
+		const CTest VTests [] = { Test_CutInputStr, Test_FindMatchMask, Test_ClearRuns, Test_StabilizeTiles,
+								  Test_IsMoveValid, Test_PlayMoveAllocations, Test_SelectRules, Test_BitBoardCascade,
+								  Test_SearchPolicyAllocations, Test_Solver, Test_ScoreStore, Test_HandleSessionLine };
+
+		unsigned NbFailed (0);
+		for (unsigned i (0); i < sizeof (VTests) / sizeof (VTests [0]); ++i)
+			if (!VTests [i] ()) ++NbFailed;
+
+		cout << NbFailed << " test(s) en echec sur " << sizeof (VTests) / sizeof (VTests [0]) << endl;
+		return 0 == NbFailed;
+
+	}// RunTests ()
+
 }// namespace
 
 /**
- * \fn int main()
+ * \fn void* operator new (size_t Size)
+ * \brief the allocation of the whole program, counted by nsNumberCrush::AllocationCount.
+ */
+void* operator new (size_t Size)
+{
+	++nsNumberCrush::AllocationCount ();
+
+	void* Ptr = malloc (Size ? Size : 1);
+	if (!Ptr) throw bad_alloc ();
+
+	return Ptr;
+
+}// operator new ()
+
+/**
+ * \fn void* operator new [] (size_t Size)
+ * \brief the allocation of an array, counted as one allocation.
+ */
+void* operator new [] (size_t Size)
+{
+	return operator new (Size);
+
+}// operator new [] ()
+
+/**
+ * \fn void* operator new (size_t Size, const nothrow_t&) noexcept
+ * \brief the allocation returning NULL on failure, used by the temporary buffers of the library.
+ */
+void* operator new (size_t Size, const nothrow_t&) noexcept
+{
+	++nsNumberCrush::AllocationCount ();
+
+	return malloc (Size ? Size : 1);
+
+}// operator new ()
+
+/**
+ * \fn void* operator new [] (size_t Size, const nothrow_t&) noexcept
+ * \brief the allocation of an array returning NULL on failure.
+ */
+void* operator new [] (size_t Size, const nothrow_t& NoThrow) noexcept
+{
+	return operator new (Size, NoThrow);
+
+}// operator new [] ()
+
+/**
+ * \fn void operator delete (void* Ptr) noexcept
+ * \brief the release of a block of operator new.
+ *
+ * Not inlined : the compiler would see free called on a block of operator new.
+ */
+__attribute__ ((noinline))
+void operator delete (void* Ptr) noexcept
+{
+	free (Ptr);
+
+}// operator delete ()
+
+/**
+ * \fn void operator delete (void* Ptr, size_t) noexcept
+ * \brief the sized release of a block of operator new.
+ */
+void operator delete (void* Ptr, size_t) noexcept
+{
+	operator delete (Ptr);
+
+}// operator delete ()
+
+/**
+ * \fn void operator delete [] (void* Ptr) noexcept
+ * \brief the release of a block of operator new [].
+ */
+void operator delete [] (void* Ptr) noexcept
+{
+	operator delete (Ptr);
+
+}// operator delete [] ()
+
+/**
+ * \fn void operator delete [] (void* Ptr, size_t) noexcept
+ * \brief the sized release of a block of operator new [].
+ */
+void operator delete [] (void* Ptr, size_t) noexcept
+{
+	operator delete (Ptr);
+
+}// operator delete [] ()
+
+/**
+ * \fn int main (int argc, char* argv [])
  * \brief Program main menu.
  *
+ * "--simulate N" plays N games without display and shows score statistics,
+ * "--seed S" and "--threads T" set the master seed and the number of threads of the simulation,
+ * "--policy P" the player (random, greedy, expectimax, montecarlo) and "--budget MS" its time per move ;
+ * "--save-scores 1" records the results of the simulation with the scores of the players, the policy being the player.
+ * "--replay FILE" plays a recorded game again and checks its score, "--verify-dir DIR" checks every
+ * recorded game of a directory in parallel.
+ * "--bench FILE" measures the kernels and writes the results in a JSON file.
+ * "--serve PORT" hosts the games of many clients on a TCP port, "--load-test PORT" plays
+ * "--clients N" games at once against it and shows the latency of the moves.
+ * "--top K" shows the K best scores recorded, "--leaderboard K" the K best ones of the settings of the config file.
+ * "--solve FILE" searches the best NbMaxTimes moves from the matrix of a text file, the refills being drawn
+ * from the seed, in "--budget MS" at most, with a transposition table of "--table MB" ; "--max-gain G" prunes
+ * the sequences which can not beat the best score if no move wins more than G points.
+ * The seed and the number of threads default to the Seed and NbThreads settings of the config file.
+ * "--test" runs every test function, without reading the config file, and fails if one of them finds an error.
+ *
  */
-int main ()
+int main (int argc, char* argv [])
 {
 	srand (time (NULL));
 
-	if (!nsNumberCrush::IsReadable (nsNumberCrush::KConfigFileName))
-		nsNumberCrush::CreateConfigFile ();
-	
-	nsNumberCrush::MainMenu ();
+	if (2 == argc && string (argv [1]) == "--test")
+		return nsNumberCrush::RunTests () ? EXIT_SUCCESS : EXIT_FAILURE;
+
+	nsNumberCrush::CConfig Settings;
+	if (!Settings.Load ())
+		Settings.Save ();
+
+	unsigned NbGames (0), BudgetMs (0), ServePort (0), LoadPort (0);
+	unsigned NbClients = nsNumberCrush::KLoadClients;
+	unsigned NbTop (0), NbLeaderboard (0);
+	unsigned TableMb = nsNumberCrush::KSolverTableMb, GainBound (0);
+	unsigned NbThreads = Settings.Get ("NbThreads");
+	unsigned long long Seed = Settings.Get ("Seed") ? Settings.Get ("Seed") : (unsigned long long) time (NULL);
+	string PolicyName ("random"), ReplayName, VerifyDirName, BenchName, StatsName, BoardName;
+	bool IsSimulation (false), IsSaveScores (false);
+	for (int i (1); i + 1 < argc; i += 2)
+	{
+		const string Option (argv [i]), Value (argv [i + 1]);
+		if (Option == "--policy")
+			PolicyName = Value;
+		else if (Option == "--replay")
+			ReplayName = Value;
+		else if (Option == "--verify-dir")
+			VerifyDirName = Value;
+		else if (Option == "--bench")
+			BenchName = Value;
+		else if (Option == "--stats")
+			StatsName = Value;
+		else if (Option == "--solve")
+			BoardName = Value;
+		if (!nsNumberCrush::IsOfType <unsigned long long> (Value)) continue;
+
+		if (Option == "--simulate")
+		{
+			IsSimulation = true;
+			NbGames = nsNumberCrush::ConvertStr <unsigned> (Value);
+		}
+		else if (Option == "--seed")
+			Seed = nsNumberCrush::ConvertStr <unsigned long long> (Value);
+		else if (Option == "--threads")
+			NbThreads = nsNumberCrush::ConvertStr <unsigned> (Value);
+		else if (Option == "--budget")
+			BudgetMs = nsNumberCrush::ConvertStr <unsigned> (Value);
+		else if (Option == "--serve")
+			ServePort = nsNumberCrush::ConvertStr <unsigned> (Value);
+		else if (Option == "--load-test")
+			LoadPort = nsNumberCrush::ConvertStr <unsigned> (Value);
+		else if (Option == "--clients")
+			NbClients = nsNumberCrush::ConvertStr <unsigned> (Value);
+		else if (Option == "--top")
+			NbTop = nsNumberCrush::ConvertStr <unsigned> (Value);
+		else if (Option == "--leaderboard")
+			NbLeaderboard = nsNumberCrush::ConvertStr <unsigned> (Value);
+		else if (Option == "--table")
+			TableMb = nsNumberCrush::ConvertStr <unsigned> (Value);
+		else if (Option == "--max-gain")
+			GainBound = nsNumberCrush::ConvertStr <unsigned> (Value);
+		else if (Option == "--save-scores")
+			IsSaveScores = 0 != nsNumberCrush::ConvertStr <unsigned> (Value);
+	}
+
+	if (!ReplayName.empty ())
+		return nsNumberCrush::ReplayFile (ReplayName) ? EXIT_SUCCESS : EXIT_FAILURE;
+
+	if (!BenchName.empty ())
+		return nsNumberCrush::Bench (BenchName) ? EXIT_SUCCESS : EXIT_FAILURE;
+
+	if (!VerifyDirName.empty ())
+		return nsNumberCrush::VerifyReplayDir (VerifyDirName, NbThreads) ? EXIT_SUCCESS : EXIT_FAILURE;
+
+	if (0 != NbTop)
+		return nsNumberCrush::ShowBestScores (NbTop) ? EXIT_SUCCESS : EXIT_FAILURE;
+
+	if (0 != NbLeaderboard)
+	{
+		nsNumberCrush::CGameConfig Config;
+		nsNumberCrush::LoadGameConfig (Settings, Config);
+		return nsNumberCrush::ShowBestScores (NbLeaderboard, &Config) ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	if (!BoardName.empty ())
+	{
+		nsNumberCrush::CGameConfig Config;
+		nsNumberCrush::LoadGameConfig (Settings, Config);
+		return nsNumberCrush::Solve (Config, BoardName, Seed, TableMb, BudgetMs, GainBound) ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	if (0 != LoadPort)
+		return nsNumberCrush::LoadTest (LoadPort, NbClients) ? EXIT_SUCCESS : EXIT_FAILURE;
+
+	if (0 != ServePort)
+	{
+		nsNumberCrush::CGameConfig Config;
+		nsNumberCrush::LoadGameConfig (Settings, Config);
+		return nsNumberCrush::Serve (Config, ServePort, Seed) ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	if (IsSimulation)
+	{
+		nsNumberCrush::CGameConfig Config;
+		nsNumberCrush::LoadGameConfig (Settings, Config);
+		nsNumberCrush::Simulate (Config, NbGames, Seed, NbThreads, PolicyName, BudgetMs, StatsName, IsSaveScores);
+		return EXIT_SUCCESS;
+	}
+
+	nsNumberCrush::MainMenu (Settings, StatsName);
 	
-	return EXIT_SUCESS;
+	return EXIT_SUCCESS;
 
 }// main ()
-